@@ -6,15 +6,50 @@
 
 #include<iostream>
 #include<iomanip> //! accès à setw()
-#include<cstdlib> //! accès à rand()
+#include<cstdlib>
 #include<vector>
 #include<string>
 #include<cctype> //! accès à toupper ()
 #include<utility> //! accès au type pair
 #include<map> //! accès au type name
+#include<unordered_map>
 #include<fstream> //! manipulation des fichiers
 #include<unistd.h>//! includes pour la fonction set_input_mode
 #include<termios.h>
+#include<sys/ioctl.h> //! taille du terminal
+#include<poll.h> //! saisie non bloquante et pendule des joueurs
+#include<sys/timerfd.h>
+#include<algorithm>
+#include<stdexcept> //! accès à out_of_range
+#include<random> //! générateurs pseudo-aléatoires propres à chaque partie
+#include<thread>
+#include<mutex>
+#include<atomic> //! arbre de recherche partagé par les threads du joueur Monte-Carlo
+#include<cmath>
+#include<deque>
+#include<functional>
+#include<climits>
+#include<chrono> //! budget de temps des joueurs ordinateur
+#include<cerrno>
+#include<cstdint>
+#include<cstring>
+#include<fcntl.h> //! journal binaire des parties, lu par mmap ()
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/file.h> //! verrou du classement
+#include<sys/epoll.h> //! serveur de parties
+#include<sys/socket.h>
+#include<sys/un.h>
+#include<netinet/in.h>
+#include<arpa/inet.h>
+#include<csignal>
+#include<memory>
+#include<condition_variable> //! écriture des points de reprise en arrière-plan
+#include<sstream> //! résumés de la télémétrie
+#include<new> //! compteur d'allocations des microbenchmarks
+#if defined (__AVX2__) || defined (__SSE2__)
+#include<immintrin.h> //! requêtes vectorisées sur les plans d'occupation
+#endif
 
 using namespace std;
 
@@ -24,17 +59,550 @@ using namespace std;
  */
 namespace{
 
-    //! 27. Un type représentant une ligne de la grille.
-    typedef vector <char> CVLine;
-    //! 29. Un type représentant la grille.
-    typedef vector <CVLine> CMatrix;
     //! 31. Un type représentant une coordonnée dans la grille.
     typedef pair   <unsigned, unsigned> CPosition;
+
+    /*!
+     * \struct CMatrix
+     * \brief Un type représentant la grille : les cases sont rangées ligne par ligne dans un seul bloc contigu.
+     * mat (i, j) et mat [pos] n'effectuent aucune vérification ; mat.at (i, j) lève out_of_range hors de la grille.
+     */
+    struct CMatrix {
+        //! Nombre de lignes (et de colonnes, la grille est carrée).
+        unsigned     side = 0;
+        //! Les side * side cases.
+        vector<char> cells;
+
+        size_t Index (const unsigned & i, const unsigned & j) const { return size_t (i) * side + j; }
+
+        char &       operator() (const unsigned & i, const unsigned & j)       { return cells [Index (i, j)]; }
+        const char & operator() (const unsigned & i, const unsigned & j) const { return cells [Index (i, j)]; }
+        char &       operator[] (const CPosition & pos)       { return cells [Index (pos.first, pos.second)]; }
+        const char & operator[] (const CPosition & pos) const { return cells [Index (pos.first, pos.second)]; }
+
+        char & at (const unsigned & i, const unsigned & j){
+            if (i >= side || j >= side) throw out_of_range ("CMatrix::at");
+            return cells [Index (i, j)];
+        }
+        const char & at (const unsigned & i, const unsigned & j) const {
+            if (i >= side || j >= side) throw out_of_range ("CMatrix::at");
+            return cells [Index (i, j)];
+        }
+
+        //! Début de la ligne i, pour parcourir une ligne sans recalculer l'indice.
+        const char * Row (const unsigned & i) const { return cells.data () + Index (i, 0); }
+    };
     //! 33. Un type utilisé pour stocker le nom et la couleur des joueurs.
     typedef pair   <string, string> CPairString;
     //! 35. Un type utilisé pour faire des vecteurs de pairs (ici 2 strings).
     typedef vector <CPairString> CVPairStr;
 
+    /*!
+     * \struct CRng
+     * \brief Générateur pseudo-aléatoire xoshiro256** d'une partie. Chaque partie a le sien, ce qui permet d'en jouer plusieurs en parallèle.
+     * Il est initialisé par une graine explicite : la même graine et les mêmes coups redonnent exactement la même partie.
+     */
+    struct CRng {
+        uint64_t state [4];
+
+        static uint64_t Rotl (const uint64_t & x, const int & k) { return (x << k) | (x >> (64 - k)); }
+
+        void Seed (uint64_t seed){
+            //! splitmix64 répartit la graine sur les 256 bits d'état, qui ne sont jamais tous nuls.
+            for (uint64_t & word : state){
+                uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        uint64_t operator() (){
+            const uint64_t result (Rotl (state [1] * 5, 7) * 9);
+            const uint64_t t      (state [1] << 17);
+            state [2] ^= state [0];
+            state [3] ^= state [1];
+            state [1] ^= state [2];
+            state [0] ^= state [3];
+            state [2] ^= t;
+            state [3]  = Rotl (state [3], 45);
+            return result;
+        }
+    };
+
+    /*!
+     * \enum TPlayerKind
+     * \brief Qui choisit les coups d'un joueur.
+     */
+    enum TPlayerKind {
+        KHuman,         //!< Saisie au clavier.
+        KComputerSearch, //!< Recherche alpha-bêta (SearchMove ()).
+        KComputerMcts    //!< Recherche Monte-Carlo multi-thread (MctsMove ()).
+    };
+
+    /*!
+     * \enum TTournament
+     * \brief Formule du tournoi du mode multijoueur.
+     */
+    enum TTournament {
+        KKnockout, //!< Élimination directe : le perdant de chaque partie est éliminé.
+        KSwiss     //!< Système suisse : chacun joue toutes les rondes contre un adversaire de même bilan.
+    };
+
+    /*!
+     * \enum TStepStatus
+     * \brief Résultat d'un appel à Step ().
+     */
+    enum TStepStatus {
+        KStepOk,         //!< Le coup a été joué.
+        KStepOutOfBoard, //!< Le pion sortirait de la matrice, rien n'est modifié.
+        KStepBadKey,     //!< La touche ne correspond à aucun déplacement, rien n'est modifié.
+        KStepGameOver    //!< La partie est déjà terminée, rien n'est modifié.
+    };
+
+    /*!
+     * \struct CBitPlane
+     * \brief Plan d'occupation : un bit par case de la grille (indice i * side + j), à 1 quand la case contient le pion du plan.
+     */
+    struct CBitPlane {
+        vector<uint64_t> words;
+
+        void Reset (const size_t & nbCells)  { words.assign ((nbCells + 63) / 64, 0); }
+        void Set   (const size_t & cell)       { words [cell >> 6] |=  (uint64_t (1) << (cell & 63)); }
+        void Clear (const size_t & cell)       { words [cell >> 6] &= ~(uint64_t (1) << (cell & 63)); }
+        bool Test  (const size_t & cell) const { return (words [cell >> 6] >> (cell & 63)) & 1; }
+    };
+
+    /*!
+     * \struct CCoinStore
+     * \brief Les pièces présentes sur la grille, repérées par leur indice de case (i * side + j).
+     * Ajout, recherche et retrait en temps constant : cells est parcouru sans ordre et slot donne la place de chaque case dans cells.
+     */
+    struct CCoinStore {
+        vector<size_t>                  cells;
+        unordered_map<size_t, unsigned> slot;
+        //! Nombre de pièces de chaque bloc de la minicarte (mapRows x mapCols blocs), tenu à jour par AddCoin () et RemoveCoin ().
+        //! Vide tant qu'aucune minicarte n'a été affichée ; reconstruit par CountCoinBlocks () quand la minicarte change de taille :
+        //! c'est pourquoi l'affichage d'une partie (ComposeMatrix (), ComposeMelee ()) prend son état par référence non constante.
+        unsigned                        mapRows = 0;
+        unsigned                        mapCols = 0;
+        vector<unsigned>                VBlock;
+    };
+
+    /*!
+     * \struct CFreeCells
+     * \brief Index des cases vides (sans joueur, pièce ni carré rouge) : tirer, retirer ou remettre une case se fait en temps constant.
+     * Les count premières places de la permutation slot -> case sont les cases vides, les suivantes les cases occupées ; cellSlot est la permutation inverse.
+     * Sur les petites grilles les deux permutations sont des tableaux. Au-delà de KDenseLimit cases, seules les places qui diffèrent de l'identité sont
+     * gardées dans des tables de hachage, pour que la mémoire dépende du nombre de cases occupées et non de la taille de la grille.
+     */
+    struct CFreeCells {
+        static const size_t KDenseLimit = size_t (1) << 22;
+
+        size_t                          count = 0;
+        bool                            dense = true;
+        vector<uint32_t>                slotCell;
+        vector<uint32_t>                cellSlot;
+        unordered_map<size_t, size_t>   sparseSlotCell;
+        unordered_map<size_t, size_t>   sparseCellSlot;
+
+        void Reset (const size_t & nbCells){
+            count = nbCells;
+            dense = nbCells <= KDenseLimit;
+            sparseSlotCell.clear ();
+            sparseCellSlot.clear ();
+            if (dense){
+                slotCell.resize (nbCells);
+                cellSlot.resize (nbCells);
+                for (size_t i(0); i < nbCells; ++i)
+                    slotCell [i] = cellSlot [i] = i;
+            }
+            else {
+                slotCell.clear ();
+                cellSlot.clear ();
+            }
+        }
+
+        size_t CellAt (const size_t & slot) const {
+            if (dense) return slotCell [slot];
+            unordered_map<size_t, size_t>::const_iterator it (sparseSlotCell.find (slot));
+            return it == sparseSlotCell.end () ? slot : it->second;
+        }
+        size_t SlotOf (const size_t & cell) const {
+            if (dense) return cellSlot [cell];
+            unordered_map<size_t, size_t>::const_iterator it (sparseCellSlot.find (cell));
+            return it == sparseCellSlot.end () ? cell : it->second;
+        }
+
+        bool Contains (const size_t & cell) const { return SlotOf (cell) < count; }
+
+        //! Retire la case des cases vides, si elle y est.
+        void Remove (const size_t & cell){
+            if (Contains (cell)) Swap (cell, --count);
+        }
+        //! Remet la case dans les cases vides, si elle n'y est pas.
+        void Insert (const size_t & cell){
+            if (!Contains (cell)) Swap (cell, count++);
+        }
+
+    private:
+        //! Place cell à la place slot et la case qui y était à l'ancienne place de cell.
+        void Swap (const size_t & cell, const size_t & slot){
+            const size_t oldSlot (SlotOf (cell));
+            const size_t other   (CellAt (slot));
+            Assign (oldSlot, other);
+            Assign (slot, cell);
+        }
+        void Assign (const size_t & slot, const size_t & cell){
+            if (dense){
+                slotCell [slot] = cell;
+                cellSlot [cell] = slot;
+                return;
+            }
+            if (slot == cell){
+                sparseSlotCell.erase (slot);
+                sparseCellSlot.erase (cell);
+            }
+            else {
+                sparseSlotCell [slot] = cell;
+                sparseCellSlot [cell] = slot;
+            }
+        }
+    };
+
+    /*!
+     * \enum TPlane
+     * \brief Indices des plans d'occupation de CGameState, un par type de pion.
+     */
+    enum TPlane {
+        KPlanePlayer1,
+        KPlanePlayer2,
+        KPlaneRedSquare,
+        KPlaneCoin,
+        KNbPlanes
+    };
+
+    //! Sous-intervalles par puissance de deux des histogrammes de latence : précision relative de 1/32 (environ 3 %), comme HdrHistogram.
+    const unsigned KHistSubBits = 5;
+    //! Durées en nanosecondes. Au-delà de 2^41 ns (environ 36 minutes), elles tombent dans le dernier intervalle.
+    const unsigned KHistBuckets = (41 - KHistSubBits + 1) << KHistSubBits;
+
+    /*!
+     * \enum TProbe
+     * \brief Étapes d'un tour dont la durée est mesurée par la télémétrie.
+     */
+    enum TProbe {
+        KProbeRender,     //!< ShowMatrix () : composition, différences et write ().
+        KProbeInputWait,  //!< PromptMove () : attente de la touche du joueur.
+        KProbeValidation, //!< Step () hors apparitions : vérification du coup et règles.
+        KProbeSpawn,      //!< SpawnTokens () : apparition du carré rouge et des pièces.
+        KNbProbes
+    };
+
+    /*!
+     * \enum TCounter
+     * \brief Compteurs de la télémétrie.
+     */
+    enum TCounter {
+        KCounterBytes,     //!< Octets envoyés au terminal (ou aux clients du serveur) par le rendu.
+        KCounterReprompts, //!< Saisies redemandées par MoveToken () : "Deplacement impossible." ou "Saisie incorrecte.".
+        KCounterSpawnFull, //!< Apparitions abandonnées faute de case vide. GeneratePosition () tire une case libre du premier coup : il n'y a plus de nouveaux tirages à compter.
+        KNbCounters
+    };
+
+    /*!
+     * \struct CHistogram
+     * \brief Histogramme de durées à précision relative constante : 2^KHistSubBits intervalles par puissance de deux.
+     * Les compteurs sont atomiques : le fil de SIGUSR1 peut le lire pendant que les parties l'alimentent.
+     */
+    struct CHistogram {
+        atomic<uint64_t> counts [KHistBuckets];
+        atomic<uint64_t> total;
+        atomic<uint64_t> sumNs;
+        atomic<uint64_t> maxNs;
+    };
+
+    /*!
+     * \struct CTelemetry
+     * \brief Mesures d'une partie ou du processus : un histogramme par TProbe et les compteurs TCounter.
+     */
+    struct CTelemetry {
+        CHistogram       probes [KNbProbes];
+        atomic<uint64_t> counters [KNbCounters];
+    };
+
+    //! Télémétrie de tout le processus, alimentée par toutes les parties. Vide tant que TelemetryPath n'est pas renseigné.
+    CTelemetry Telemetry;
+    //! Fichier où la télémétrie est écrite à la sortie et à chaque SIGUSR1 (--telemetry), vide si elle est désactivée.
+    string TelemetryPath;
+    //! Résumé de chaque partie terminée, dans l'ordre, protégé par TelemetryLock.
+    vector<string> VTelemetryMatch;
+    mutex          TelemetryLock;
+
+    /*!
+     * \fn unsigned HistBucket (const uint64_t & ns)
+     * \brief Intervalle de l'histogramme contenant la durée ns.
+     */
+    unsigned HistBucket (const uint64_t & ns){
+        if (ns < (1u << KHistSubBits)) return ns;
+        const unsigned shift (63 - __builtin_clzll (ns) - KHistSubBits);
+        return min (((shift + 1) << KHistSubBits) + unsigned (ns >> shift) - (1u << KHistSubBits), KHistBuckets - 1);
+    } // HistBucket ()
+
+    /*!
+     * \fn uint64_t HistBucketEnd (const unsigned & bucket)
+     * \brief Plus grande durée de l'intervalle bucket.
+     */
+    uint64_t HistBucketEnd (const unsigned & bucket){
+        if (bucket < (1u << KHistSubBits)) return bucket;
+        const unsigned shift ((bucket >> KHistSubBits) - 1);
+        return ((uint64_t ((1u << KHistSubBits) + (bucket & ((1u << KHistSubBits) - 1))) + 1) << shift) - 1;
+    } // HistBucketEnd ()
+
+    /*!
+     * \fn void HistRecord (CHistogram & hist, const uint64_t & ns)
+     * \brief Ajoute une durée à l'histogramme.
+     */
+    void HistRecord (CHistogram & hist, const uint64_t & ns){
+        hist.counts [HistBucket (ns)].fetch_add (1, memory_order_relaxed);
+        hist.total.fetch_add (1, memory_order_relaxed);
+        hist.sumNs.fetch_add (ns, memory_order_relaxed);
+        for (uint64_t seen (hist.maxNs.load (memory_order_relaxed)); seen < ns && !hist.maxNs.compare_exchange_weak (seen, ns, memory_order_relaxed););
+    } // HistRecord ()
+
+    /*!
+     * \fn uint64_t HistPercentile (const CHistogram & hist, const double & percent)
+     * \brief Durée sous laquelle se trouvent percent % des mesures, à la précision de l'histogramme près.
+     */
+    uint64_t HistPercentile (const CHistogram & hist, const double & percent){
+        const uint64_t total (hist.total.load (memory_order_relaxed));
+        const uint64_t rank (max (uint64_t (ceil (total * percent / 100.0)), uint64_t (1)));
+        uint64_t seen (0);
+        for (unsigned bucket(0); bucket < KHistBuckets; ++bucket)
+            if ((seen += hist.counts [bucket].load (memory_order_relaxed)) >= rank)
+                return min (HistBucketEnd (bucket), hist.maxNs.load (memory_order_relaxed));
+        return hist.maxNs.load (memory_order_relaxed);
+    } // HistPercentile ()
+
+    /*!
+     * \fn void ResetTelemetry (CTelemetry & telemetry)
+     * \brief Remet toutes les mesures à zéro, avant une nouvelle partie.
+     */
+    void ResetTelemetry (CTelemetry & telemetry){
+        for (CHistogram & hist : telemetry.probes){
+            for (atomic<uint64_t> & count : hist.counts)
+                count.store (0, memory_order_relaxed);
+            hist.total.store (0, memory_order_relaxed);
+            hist.sumNs.store (0, memory_order_relaxed);
+            hist.maxNs.store (0, memory_order_relaxed);
+        }
+        for (atomic<uint64_t> & counter : telemetry.counters)
+            counter.store (0, memory_order_relaxed);
+    } // ResetTelemetry ()
+
+    /*!
+     * \fn CTelemetry * SharedTelemetry ()
+     * \brief Télémétrie du processus si --telemetry est actif, nullptr sinon : c'est la valeur à donner à CGameState::telemetry pour les parties sans mesures propres.
+     */
+    CTelemetry * SharedTelemetry (){
+        return TelemetryPath.empty () ? nullptr : &Telemetry;
+    } // SharedTelemetry ()
+
+    /*!
+     * \fn uint64_t ProbeStart (const CTelemetry * telemetry)
+     * \brief Instant de début d'une mesure, en nanosecondes. Sans télémétrie l'horloge n'est pas lue.
+     */
+    uint64_t ProbeStart (const CTelemetry * telemetry){
+        if (!telemetry) return 0;
+        return chrono::duration_cast<chrono::nanoseconds> (chrono::steady_clock::now ().time_since_epoch ()).count ();
+    } // ProbeStart ()
+
+    /*!
+     * \fn void ProbeStop (CTelemetry * telemetry, const TProbe & probe, const uint64_t & start)
+     * \brief Enregistre la durée écoulée depuis start dans la télémétrie de la partie et dans celle du processus.
+     */
+    void ProbeStop (CTelemetry * telemetry, const TProbe & probe, const uint64_t & start){
+        if (!telemetry) return;
+        const uint64_t ns (ProbeStart (telemetry) - start);
+        HistRecord (telemetry->probes [probe], ns);
+        if (telemetry != &Telemetry) HistRecord (Telemetry.probes [probe], ns);
+    } // ProbeStop ()
+
+    /*!
+     * \fn void AddCounter (CTelemetry * telemetry, const TCounter & counter, const uint64_t & value)
+     * \brief Ajoute value au compteur de la partie et à celui du processus.
+     */
+    void AddCounter (CTelemetry * telemetry, const TCounter & counter, const uint64_t & value){
+        if (!telemetry) return;
+        telemetry->counters [counter].fetch_add (value, memory_order_relaxed);
+        if (telemetry != &Telemetry) Telemetry.counters [counter].fetch_add (value, memory_order_relaxed);
+    } // AddCounter ()
+
+    /*!
+     * \fn string TelemetryReport (const CTelemetry & telemetry)
+     * \brief Une ligne par étape mesurée (nombre, moyenne, percentiles et maximum en microsecondes), puis les compteurs.
+     */
+    string TelemetryReport (const CTelemetry & telemetry){
+        static const char * const VProbeName [KNbProbes]     = {"rendu", "attente_saisie", "validation", "apparitions"};
+        static const char * const VCounterName [KNbCounters] = {"octets_ecrits", "ressaisies", "grille_pleine"};
+        ostringstream report;
+        report << fixed << setprecision (1);
+        for (unsigned probe(0); probe < KNbProbes; ++probe){
+            const CHistogram & hist (telemetry.probes [probe]);
+            const uint64_t total (hist.total.load (memory_order_relaxed));
+            report << "  " << left << setw (16) << VProbeName [probe] << right << " n=" << total;
+            if (total != 0)
+                report << " moy=" << hist.sumNs.load (memory_order_relaxed) / 1000.0 / total
+                       << " p50=" << HistPercentile (hist, 50) / 1000.0 << " p90=" << HistPercentile (hist, 90) / 1000.0
+                       << " p99=" << HistPercentile (hist, 99) / 1000.0 << " p99.9=" << HistPercentile (hist, 99.9) / 1000.0
+                       << " max=" << hist.maxNs.load (memory_order_relaxed) / 1000.0 << " us";
+            report << '\n';
+        }
+        for (unsigned counter(0); counter < KNbCounters; ++counter)
+            report << "  " << left << setw (16) << VCounterName [counter] << right << ' ' << telemetry.counters [counter].load (memory_order_relaxed) << '\n';
+        return report.str ();
+    } // TelemetryReport ()
+
+    /*!
+     * \fn void FinishMatchTelemetry (const CTelemetry & telemetry, const string & title)
+     * \brief Garde le résumé d'une partie terminée pour les prochaines écritures du fichier de télémétrie.
+     */
+    void FinishMatchTelemetry (const CTelemetry & telemetry, const string & title){
+        if (TelemetryPath.empty ()) return;
+        const string report ("partie " + title + "\n" + TelemetryReport (telemetry));
+        lock_guard<mutex> guard (TelemetryLock);
+        VTelemetryMatch.push_back (report);
+    } // FinishMatchTelemetry ()
+
+    /*!
+     * \fn void DumpTelemetry ()
+     * \brief Écrit la télémétrie du processus puis le résumé de chaque partie terminée dans TelemetryPath.
+     * Le fichier est écrit à côté puis renommé : un lecteur ne voit jamais un fichier à moitié écrit.
+     */
+    void DumpTelemetry (){
+        if (TelemetryPath.empty ()) return;
+        lock_guard<mutex> guard (TelemetryLock);
+        const string temporary (TelemetryPath + ".tmp");
+        {
+            ofstream file (temporary, ios::trunc);
+            file << "processus " << getpid () << "\n" << TelemetryReport (Telemetry);
+            for (const string & match : VTelemetryMatch)
+                file << match;
+            if (!file) return;
+        }
+        rename (temporary.c_str (), TelemetryPath.c_str ());
+    } // DumpTelemetry ()
+
+    /*!
+     * \fn void StartTelemetry (const string & path)
+     * \brief Active la télémétrie : elle sera écrite dans path à la sortie du programme et à chaque SIGUSR1.
+     * SIGUSR1 est bloqué puis attendu par un fil dédié (sigwait ()) : à appeler avant de créer d'autres threads, qui héritent du masque.
+     */
+    void StartTelemetry (const string & path){
+        TelemetryPath = path;
+        ResetTelemetry (Telemetry);
+        sigset_t signals;
+        sigemptyset (&signals);
+        sigaddset (&signals, SIGUSR1);
+        pthread_sigmask (SIG_BLOCK, &signals, nullptr);
+        thread ([signals] (){
+            for (int signal; sigwait (&signals, &signal) == 0;)
+                DumpTelemetry ();
+        }).detach ();
+        atexit (DumpTelemetry);
+    } // StartTelemetry ()
+
+    /*!
+     * \struct CGameState
+     * \brief État complet d'une partie, manipulé par le moteur sans aucune entrée/sortie.
+     */
+    struct CGameState {
+        //! La grille.
+        CMatrix           mat;
+        //! Taille de la grille (carrée).
+        unsigned          matrixSize;
+        //! Position des pions des deux joueurs.
+        CPosition         posPlayer1;
+        CPosition         posPlayer2;
+        //! Position du carré rouge, valide uniquement quand doesRedSquare vaut false.
+        CPosition         posRedSquare;
+        //! Vaut true tant que le carré rouge n'est pas apparu.
+        bool              doesRedSquare;
+        //! Pièces présentes sur la grille. Une pièce ramassée en est retirée.
+        CCoinStore        VPosCoin;
+        //! Plans d'occupation, indicés par TPlane, tenus à jour par le moteur.
+        CBitPlane         planes [KNbPlanes];
+        //! Cases vides, où peuvent apparaitre les pions spéciaux.
+        CFreeCells        freeCells;
+        //! Scores des joueurs 1 et 2.
+        unsigned          VScore [2];
+        //! Nombre de tours restants.
+        unsigned          compteTour;
+        //! Joueur qui doit jouer, 1 ou 2.
+        unsigned          turn;
+        //! 0 tant que personne n'a gagné par capture, carré rouge ou au temps, sinon 1 ou 2.
+        unsigned          winner;
+        //! Le vainqueur l'a emporté parce que son adversaire n'avait plus de temps (Forfeit ()).
+        bool              timeForfeit;
+        //! Nombre de coups joués par chaque joueur.
+        unsigned          cptJ1;
+        unsigned          cptJ2;
+        //! Probabilité (en %) d'apparition des pions spéciaux à chaque coup.
+        unsigned          chance;
+        //! Graine de la partie et générateur utilisé pour les apparitions, initialisés par InitGame ().
+        uint64_t          seed;
+        CRng              rng;
+        //! Coups joués depuis le début de la partie, pour pouvoir la rejouer.
+        vector<char>      VMove;
+        //! Le résultat ne pouvait plus changer : la partie s'est arrêtée avant la fin des tours (earlyEnd).
+        bool              decided;
+        //! Arrêter la partie dès que son résultat est acquis (IsDecided ()). N'est pas modifié par InitGame (). Sans lui, les tours sont joués jusqu'au bout.
+        bool              earlyEnd = false;
+        //! Mesures de la partie (--telemetry), nullptr sans télémétrie. N'est pas modifié par InitGame () : c'est à l'appelant de le renseigner.
+        CTelemetry *      telemetry = nullptr;
+    };
+
+    /*!
+     * \enum TOutcome
+     * \brief Façon dont une partie s'est terminée.
+     */
+    enum TOutcome {
+        KOutcomePoints,   //!< Plus de tours : le plus de points l'emporte, ou match nul.
+        KOutcomeCapture,  //!< Un joueur a pris l'autre.
+        KOutcomeRedSquare, //!< Un joueur a atteint le carré rouge.
+        KOutcomeTime       //!< Un joueur a dépassé le temps de sa pendule.
+    };
+
+    /*!
+     * \struct CMatchResult
+     * \brief Résultat complet d'une partie, tel qu'il est enregistré : joueurs, graine, coups, scores et issue.
+     * \var winner 1 ou 2, 0 pour un match nul.
+     */
+    struct CMatchResult {
+        string       names [2];
+        uint64_t     seed;
+        unsigned     matrixSize;
+        unsigned     VScore [2];
+        unsigned     winner;
+        TOutcome     outcome;
+        vector<char> VMove;
+    };
+
+    /*!
+     * \struct CCell
+     * \brief Une case de l'écran : un caractère UTF-8 et sa couleur.
+     */
+    struct CCell {
+        char          glyph [4];
+        unsigned char size;
+        //! Code couleur ANSI (0, 30 à 36).
+        unsigned char color;
+    };
+    //! Une ligne de l'écran.
+    typedef vector <CCell> CFrameLine;
+    //! Une image de l'écran, ligne par ligne.
+    typedef vector <CFrameLine> CFrame;
+
     //! 38. Pion du joueur 1.
     char TokenPlayer1 = 'X';
     //! 40. Pion du joueur 2.
@@ -64,44 +632,133 @@ namespace{
     const string KCyan    ("36");
 
     struct termios saved_attributes;
+    //! saved_attributes contient les réglages du terminal à rétablir.
+    bool           has_saved_attributes (false);
+
+    //! Image actuellement affichée par ShowMatrix (), vide quand l'écran a été effacé.
+    CFrame ScreenFrame;
 
     /*!
      * \fn void reset_input_mode (void)
      * \brief Bascule en mode canonique.
      */
     void reset_input_mode (void){
+        if (has_saved_attributes)
           tcsetattr (STDIN_FILENO, TCSANOW, &saved_attributes);
     } // reset_input_mode()
 
     /*!
-     * \fn void set_input_mode (void)
-     * \brief Bascule en mode non canonique.
+     * \fn bool set_input_mode (void)
+     * \brief Bascule en mode non canonique, sans écho, pour lire les touches une à une avec ReadKey (). Seul le premier appel agit.
+     * Le changement prend effet immédiatement (TCSANOW) : les touches déjà tapées restent à lire.
+     * \return false si l'entrée n'est pas un terminal (fichier, tube) : rien n'est changé, ReadKey () lit les octets tels qu'ils arrivent. --script joue ces entrées sans affichage.
      */
     //! http://www.gnu.org/software/libc/manual/html_node/Noncanon-Example.html
-    void set_input_mode (void){
+    bool set_input_mode (void){
         struct termios tattr;
         //! 83. Make sure stdin is a terminal.
-        if (!isatty (STDIN_FILENO)){
-            fprintf (stderr, "Not a terminal.\n");
-            exit (EXIT_FAILURE);
+        if (!isatty (STDIN_FILENO))
+            return false;
+        //! 88. Save the terminal attributes so we can restore them later, once.
+        if (!has_saved_attributes){
+            tcgetattr (STDIN_FILENO, &saved_attributes);
+            atexit (reset_input_mode);
+            has_saved_attributes = true;
         }
-        //! 88. Save the terminal attributes so we can restore them later.
-        tcgetattr (STDIN_FILENO, &saved_attributes);
-        atexit (reset_input_mode);
         //! 91. Set the funny terminal modes.
-        tcgetattr (STDIN_FILENO, &tattr);
-		//! 93. Clear ICANON and ECHO.
+        tattr = saved_attributes;
+		//! 93. Clear ICANON and ECHO. read () rend la main tout de suite : l'attente se fait dans poll ().
         tattr.c_lflag &= ~(ICANON|ECHO); 
         tattr.c_cc[VMIN] = 0;
-        tattr.c_cc[VTIME] = 200;
-        tcsetattr (STDIN_FILENO, TCSAFLUSH, &tattr);
+        tattr.c_cc[VTIME] = 0;
+        tcsetattr (STDIN_FILENO, TCSANOW, &tattr);
+        return true;
     } // set_input_mode()
 
+    //! Touches lues mais pas encore utilisées : elles servent aux saisies suivantes.
+    string PendingKeys;
+
+    /*!
+     * \fn bool ReadKey (char & key, const long long & timeoutMs)
+     * \brief Lit une touche sans passer par cin, en attendant au plus timeoutMs millisecondes (-1 : sans limite).
+     * L'attente se fait dans poll () sur l'entrée et sur un timerfd armé pour l'échéance. Sans timerfd (timerfd_create () a échoué),
+     * l'échéance est suivie avec steady_clock et passée en délai à poll ().
+     * \return false si le délai est écoulé ou si l'entrée est fermée.
+     */
+    bool ReadKey (char & key, const long long & timeoutMs){
+        static const int timer (timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
+        const bool useTimer (timeoutMs >= 0 && timer >= 0);
+        const chrono::steady_clock::time_point deadlineTime (chrono::steady_clock::now () + chrono::milliseconds (max (timeoutMs, 0LL)));
+
+        if (PendingKeys.empty () && useTimer){
+            itimerspec deadline;
+            memset (&deadline, 0, sizeof (deadline));
+            deadline.it_value.tv_sec  = timeoutMs / 1000;
+            deadline.it_value.tv_nsec = timeoutMs % 1000 * 1000000 + (timeoutMs == 0);
+            timerfd_settime (timer, 0, &deadline, nullptr);
+        }
+        while (PendingKeys.empty ()){
+            int pollTimeout (-1);
+            if (timeoutMs >= 0 && !useTimer){
+                const long long remaining (chrono::ceil<chrono::milliseconds> (deadlineTime - chrono::steady_clock::now ()).count ());
+                pollTimeout = int (min (max (remaining, 0LL), (long long) INT_MAX));
+            }
+            pollfd VPoll [2] = {{STDIN_FILENO, POLLIN, 0}, {timer, POLLIN, 0}};
+            const int ready (poll (VPoll, useTimer ? 2 : 1, pollTimeout));
+            if (ready < 0){
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (ready == 0) return false;
+            if (useTimer && (VPoll [1].revents & POLLIN)){
+                uint64_t expirations;
+                const ssize_t drained (read (timer, &expirations, sizeof (expirations)));
+                (void) drained;
+                return false;
+            }
+            if (!(VPoll [0].revents & (POLLIN | POLLHUP))) continue;
+            char buffer [256];
+            const ssize_t got (read (STDIN_FILENO, buffer, sizeof (buffer)));
+            if (got < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            if (got <= 0) return false;
+            PendingKeys.append (buffer, got);
+        }
+        key = PendingKeys [0];
+        PendingKeys.erase (0, 1);
+        return true;
+    } // ReadKey ()
+
+    /*!
+     * \fn bool PromptMove (char & move, long long & clockMs, CTelemetry * telemetry)
+     * \brief Affiche l'invite, avec le temps restant si la pendule est active, et lit la touche du joueur. Les blancs sont ignorés.
+     * \param[in-out] clockMs temps restant au joueur (-1 : pas de pendule), diminué du temps passé à attendre.
+     * \param telemetry reçoit le temps d'attente (KProbeInputWait), peut être nullptr.
+     * \return false si le joueur n'a plus de temps ou si l'entrée est fermée.
+     */
+    bool PromptMove (char & move, long long & clockMs, CTelemetry * telemetry){
+        cout << endl;
+        if (clockMs >= 0)
+            cout << "(" << clockMs / 60000 << ":" << setw (2) << setfill ('0') << clockMs / 1000 % 60 << setfill (' ') << ") ";
+        cout << "? " << flush;
+
+        const chrono::steady_clock::time_point start (chrono::steady_clock::now ());
+        bool ok;
+        do
+            ok = ReadKey (move, clockMs >= 0 ? max (clockMs - chrono::duration_cast<chrono::milliseconds> (chrono::steady_clock::now () - start).count (), 0LL) : -1);
+        while (ok && isspace ((unsigned char) move));
+        ProbeStop (telemetry, KProbeInputWait, chrono::duration_cast<chrono::nanoseconds> (start.time_since_epoch ()).count ());
+
+        if (clockMs >= 0)
+            clockMs = max (clockMs - chrono::duration_cast<chrono::milliseconds> (chrono::steady_clock::now () - start).count (), 0LL);
+        return ok && clockMs != 0;
+    } // PromptMove ()
+
     /*!
      * \fn void ClearScreen ()
      * \brief Efface ce qui est affiché sur le terminal.
      */
     void ClearScreen (){
+        ScreenFrame.clear ();
         cout << "\033[H\033[2J";
     } // ClearScreen ()
 
@@ -114,6 +771,11 @@ namespace{
     void ShowPrompt (T & var){
         cout << endl << "? ";
         cin >> var;
+        //! L'entrée est épuisée (fichier ou tube) : aucune saisie ne viendra plus.
+        if (cin.eof ()){
+            cerr << endl << "Fin de l'entrée." << endl;
+            exit (EXIT_FAILURE);
+        }
         if (cin.fail ()){
             cin.clear ();
             cin.ignore ();
@@ -129,6 +791,18 @@ namespace{
         cout << "\033[" << coul << "m";
     } // Couleur ()
 
+    /*!
+     * \fn unsigned char ColorCode (const string & coul)
+     * \brief Traduit une constante de couleur en attribut de cellule d'image.
+     * \return l'attribut, ou celui de KReset si coul n'est pas un code numérique valide.
+     */
+    unsigned char ColorCode (const string & coul){
+        if (coul.empty () || coul.size () > 3 || coul.find_first_not_of ("0123456789") != string::npos)
+            return (unsigned char) stoi (KReset);
+        const int code (stoi (coul));
+        return (unsigned char) (code > 255 ? stoi (KReset) : code);
+    } // ColorCode ()
+
     /*!
      * \fn ShowColoredName (CPairString NameColor)
      * \brief Affiche un pseudo de la couleur qui lui est associée.
@@ -181,6 +855,10 @@ namespace{
         cout << endl;
 
         ShowPrompt (choice);
+        while (choice < 1 || choice > 6){
+            cout << "Veuillez choisir une couleur entre 1 et 6 : ";
+            ShowPrompt (choice);
+        }
         cout << endl;
 
         switch (choice){
@@ -208,356 +886,5451 @@ namespace{
 
     /*!
      * \fn void InitMat (CMatrix & mat, const unsigned & matrixSize)
-     * \brief Dimmensionne la matrice à la valeur de matrixSize. On peut noter que la matrice doit être carrée, donc une seule variable suffit.
+     * \brief Dimmensionne la matrice à la valeur de matrixSize et la vide. On peut noter que la matrice doit être carrée, donc une seule variable suffit.
      */
     void InitMat (CMatrix & mat, const unsigned & matrixSize){
-        mat.resize(matrixSize);
-        for (unsigned i(0); i < mat.size(); ++i)
-            mat[i].resize(matrixSize);
+        mat.side = matrixSize;
+        mat.cells.assign (size_t (matrixSize) * matrixSize, KEmpty);
     }// InitMat()
 
+    //! Indique qu'aucune case n'a été trouvée.
+    const size_t KNoCell = size_t (-1);
+
+#if defined (__AVX2__)
     /*!
-     * \fn void ShowMatrix (const CMatrix & mat, const CVPairStr & VNameColor, const vector<unsigned> & VScore, const unsigned & playersCouple)
-     * \brief Affiche la matrice et son contenu à l'écran.
-     * \param playersCouple est un entier qui définit un "couple" de joueurs qui s'affrontent. VNameColor à l'indice playersCouple correspond au joueur 1 et l'indice playersCouple+1 au joueur 2.
-     * Affiche la matrice et son contenu à l'écran.
+     * \fn __m256i PopCount256 (const __m256i & v)
+     * \brief Nombre de bits à 1 de chacun des 4 mots de 64 bits de v (table de 16 entrées sur chaque quartet).
      */
-    void ShowMatrix (const CMatrix & mat, const CVPairStr & VNameColor, const vector<unsigned> & VScore, const unsigned & playersCouple){
-        ClearScreen();
-        Couleur (KBleu);
-        cout << "\t# Deplacements" << endl;
-        Couleur (KReset);
-        cout << "\t A   Z   E" << endl << "\t     ^" << endl << "\tQ  < o >  D " << endl << "\t     v" << endl << "\t W   X   C" << endl << endl; //! Affiche un dessin explicitant les déplacement possibles, correspondant aux lettres.
+    inline __m256i PopCount256 (const __m256i & v){
+        const __m256i lookup = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low = _mm256_set1_epi8 (0x0f);
+        const __m256i lo  = _mm256_shuffle_epi8 (lookup, _mm256_and_si256 (v, low));
+        const __m256i hi  = _mm256_shuffle_epi8 (lookup, _mm256_and_si256 (_mm256_srli_epi16 (v, 4), low));
+        return _mm256_sad_epu8 (_mm256_add_epi8 (lo, hi), _mm256_setzero_si256 ());
+    } // PopCount256 ()
+#elif defined (__SSE2__)
+    /*!
+     * \fn __m128i PopCount128 (__m128i v)
+     * \brief Nombre de bits à 1 de chacun des 2 mots de 64 bits de v (additions par paires de bits).
+     */
+    inline __m128i PopCount128 (__m128i v){
+        const __m128i m1 = _mm_set1_epi8 (0x55);
+        const __m128i m2 = _mm_set1_epi8 (0x33);
+        const __m128i m4 = _mm_set1_epi8 (0x0f);
+        v = _mm_sub_epi8 (v, _mm_and_si128 (_mm_srli_epi64 (v, 1), m1));
+        v = _mm_add_epi8 (_mm_and_si128 (v, m2), _mm_and_si128 (_mm_srli_epi64 (v, 2), m2));
+        v = _mm_and_si128 (_mm_add_epi8 (v, _mm_srli_epi64 (v, 4)), m4);
+        return _mm_sad_epu8 (v, _mm_setzero_si128 ());
+    } // PopCount128 ()
+#endif
 
-        //! Affiche les pseudos en couleur des joueurs qui s'affrontent.
-        cout << endl << '\t';
-        Couleur (VNameColor [playersCouple].second);
-        cout << VNameColor [playersCouple].first;
-        Couleur (KReset);
+    /*!
+     * \fn size_t CountTokens (const CBitPlane & plane, const CBitPlane * mask)
+     * \brief Nombre de pions du plan, restreint aux cases de mask quand il n'est pas nul.
+     */
+    inline size_t CountTokens (const CBitPlane & plane, const CBitPlane * mask){
+        const uint64_t * a (plane.words.data ());
+        const uint64_t * b (mask ? mask->words.data () : nullptr);
+        const size_t     n (plane.words.size ());
+        size_t i (0), count (0);
+#if defined (__AVX2__)
+        __m256i sum = _mm256_setzero_si256 ();
+        for (; i + 4 <= n; i += 4){
+            __m256i v = _mm256_loadu_si256 ((const __m256i *) (a + i));
+            if (b) v = _mm256_and_si256 (v, _mm256_loadu_si256 ((const __m256i *) (b + i)));
+            sum = _mm256_add_epi64 (sum, PopCount256 (v));
+        }
+        uint64_t lanes [4];
+        _mm256_storeu_si256 ((__m256i *) lanes, sum);
+        count = lanes [0] + lanes [1] + lanes [2] + lanes [3];
+#elif defined (__SSE2__)
+        __m128i sum = _mm_setzero_si128 ();
+        for (; i + 2 <= n; i += 2){
+            __m128i v = _mm_loadu_si128 ((const __m128i *) (a + i));
+            if (b) v = _mm_and_si128 (v, _mm_loadu_si128 ((const __m128i *) (b + i)));
+            sum = _mm_add_epi64 (sum, PopCount128 (v));
+        }
+        uint64_t lanes [2];
+        _mm_storeu_si128 ((__m128i *) lanes, sum);
+        count = lanes [0] + lanes [1];
+#endif
+        for (; i < n; ++i)
+            count += __builtin_popcountll (b ? (a [i] & b [i]) : a [i]);
+        return count;
+    } // CountTokens ()
 
-        cout << "\t\t" << "vs." << "\t\t";
+    /*!
+     * \fn size_t FindToken (const CBitPlane & plane, const size_t & from)
+     * \brief Indice de la première case du plan à partir de from qui contient un pion, ou KNoCell. Les mots nuls sont sautés par blocs.
+     */
+    inline size_t FindToken (const CBitPlane & plane, const size_t & from){
+        const uint64_t * a (plane.words.data ());
+        const size_t     n (plane.words.size ());
+        size_t i (from >> 6);
+        if (i >= n) return KNoCell;
 
-        Couleur (VNameColor [playersCouple + 1].second);
-        cout << VNameColor [playersCouple + 1].first;
-        Couleur (KReset);
+        //! Le premier mot est tronqué des bits qui précèdent from.
+        const uint64_t first (a [i] & (~uint64_t (0) << (from & 63)));
+        if (first != 0) return (i << 6) + __builtin_ctzll (first);
+        ++i;
+#if defined (__AVX2__)
+        for (; i + 4 <= n; i += 4){
+            const __m256i v = _mm256_loadu_si256 ((const __m256i *) (a + i));
+            if (!_mm256_testz_si256 (v, v)) break;
+        }
+#elif defined (__SSE2__)
+        for (; i + 2 <= n; i += 2){
+            const __m128i v = _mm_loadu_si128 ((const __m128i *) (a + i));
+            if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_setzero_si128 ())) != 0xFFFF) break;
+        }
+#endif
+        for (; i < n; ++i)
+            if (a [i] != 0) return (i << 6) + __builtin_ctzll (a [i]);
+        return KNoCell;
+    } // FindToken ()
 
-        //! Affiche leur score actuel.
-        Couleur (KBleu);
-        cout << endl << "Score : ";
-        Couleur (KReset);
+    /*!
+     * \fn void MaskTokens (CBitPlane & result, const CBitPlane & a, const CBitPlane & b, const bool & keepCommon)
+     * \brief result = a & b si keepCommon, a & ~b sinon. Par exemple les pièces hors de portée d'un joueur, ou les cases occupées par deux types de pions.
+     */
+    inline void MaskTokens (CBitPlane & result, const CBitPlane & a, const CBitPlane & b, const bool & keepCommon){
+        const size_t n (a.words.size ());
+        result.words.resize (n);
+        uint64_t *       r (result.words.data ());
+        const uint64_t * x (a.words.data ());
+        const uint64_t * y (b.words.data ());
+        size_t i (0);
+#if defined (__AVX2__)
+        for (; i + 4 <= n; i += 4){
+            const __m256i vx = _mm256_loadu_si256 ((const __m256i *) (x + i));
+            const __m256i vy = _mm256_loadu_si256 ((const __m256i *) (y + i));
+            _mm256_storeu_si256 ((__m256i *) (r + i), keepCommon ? _mm256_and_si256 (vx, vy) : _mm256_andnot_si256 (vy, vx));
+        }
+#elif defined (__SSE2__)
+        for (; i + 2 <= n; i += 2){
+            const __m128i vx = _mm_loadu_si128 ((const __m128i *) (x + i));
+            const __m128i vy = _mm_loadu_si128 ((const __m128i *) (y + i));
+            _mm_storeu_si128 ((__m128i *) (r + i), keepCommon ? _mm_and_si128 (vx, vy) : _mm_andnot_si128 (vy, vx));
+        }
+#endif
+        for (; i < n; ++i)
+            r [i] = keepCommon ? (x [i] & y [i]) : (x [i] & ~y [i]);
+    } // MaskTokens ()
 
-        Couleur (VNameColor [playersCouple].second);
-        cout << VScore [playersCouple];
-        Couleur (KReset);
+    /*!
+     * \fn size_t CoinBlock (const CCoinStore & VPosCoin, const size_t & cell, const uint64_t & side)
+     * \brief Bloc de la minicarte (VPosCoin.VBlock) qui contient la case cell d'une grille side x side.
+     */
+    inline size_t CoinBlock (const CCoinStore & VPosCoin, const size_t & cell, const uint64_t & side){
+        return cell / side * VPosCoin.mapRows / side * VPosCoin.mapCols + cell % side * VPosCoin.mapCols / side;
+    } // CoinBlock ()
 
-        cout << "\t\t" << "/" << "\t\t";
+    /*!
+     * \fn void CountCoinBlocks (CCoinStore & VPosCoin, const uint64_t & side, const unsigned & mapRows, const unsigned & mapCols)
+     * \brief Prépare les compteurs de pièces par bloc d'une minicarte de mapRows x mapCols blocs. Les pièces ne sont parcourues
+     * que si la minicarte change de taille (premier affichage, terminal redimensionné) ; ensuite AddCoin () et RemoveCoin () tiennent les compteurs à jour.
+     */
+    void CountCoinBlocks (CCoinStore & VPosCoin, const uint64_t & side, const unsigned & mapRows, const unsigned & mapCols){
+        if (!VPosCoin.VBlock.empty () && VPosCoin.mapRows == mapRows && VPosCoin.mapCols == mapCols) return;
+        VPosCoin.mapRows = mapRows;
+        VPosCoin.mapCols = mapCols;
+        VPosCoin.VBlock.assign (size_t (mapRows) * mapCols, 0);
+        for (const size_t & cell : VPosCoin.cells)
+            ++VPosCoin.VBlock [CoinBlock (VPosCoin, cell, side)];
+    } // CountCoinBlocks ()
 
-        Couleur (VNameColor [playersCouple + 1].second);
-        cout << VScore [playersCouple + 1];
-        Couleur (KReset);
+    /*!
+     * \fn bool AddCoin (CCoinStore & VPosCoin, CBitPlane & coinPlane, CMatrix & mat, const size_t & cell)
+     * \brief Pose une pièce sur la case cell, dans le magasin, le plan des pièces et la grille. Renvoie false s'il y a déjà une pièce.
+     */
+    bool AddCoin (CCoinStore & VPosCoin, CBitPlane & coinPlane, CMatrix & mat, const size_t & cell){
+        if (coinPlane.Test (cell)) return false;
+        coinPlane.Set (cell);
+        VPosCoin.slot [cell] = VPosCoin.cells.size ();
+        VPosCoin.cells.push_back (cell);
+        if (!VPosCoin.VBlock.empty ()) ++VPosCoin.VBlock [CoinBlock (VPosCoin, cell, mat.side)];
+        mat.cells [cell] = KTokenCoin;
+        return true;
+    } // AddCoin ()
 
-        cout << endl << endl << endl;
+    /*!
+     * \fn bool RemoveCoin (CCoinStore & VPosCoin, CBitPlane & coinPlane, CMatrix & mat, const size_t & cell)
+     * \brief Retire la pièce de la case cell. La dernière pièce de cells prend sa place. Renvoie false s'il n'y avait pas de pièce.
+     * La grille n'est vidée que si elle affiche encore la pièce (un joueur qui la ramasse occupe déjà la case).
+     */
+    bool RemoveCoin (CCoinStore & VPosCoin, CBitPlane & coinPlane, CMatrix & mat, const size_t & cell){
+        unordered_map<size_t, unsigned>::iterator it (VPosCoin.slot.find (cell));
+        if (it == VPosCoin.slot.end ()) return false;
 
-        for (unsigned i(0); i < mat.size(); ++i){
-            cout << "|";
-            for (unsigned j(0); j < mat[i].size(); ++j){
-                //! Quand les coordonnées [i][j] correspondent aux coordonnées des pions des joueurs ou du carré rouge, celui-ci est affiché de la bonne couleur. Sinon la case affichée est vide.
-                if (mat[i][j] == TokenPlayer1){
-                    Couleur (VNameColor[playersCouple].second);
-                    cout << TokenPlayer1;
-                    Couleur (KReset);
-                    cout << '|';
-                }
-                else if (mat[i][j] == TokenPlayer2){
-                    Couleur (VNameColor[playersCouple+1].second);
-                    cout << TokenPlayer2;
-                    Couleur (KReset);
-                    cout << '|';
-                }
-                else if (mat[i][j] == KTokenRedSquare){
-                    Couleur (KRouge);
-                    cout << KTokenRedSquare;
-                    Couleur (KReset);
-                    cout << '|';
-                }
-                else if (mat[i][j] == KTokenCoin){
-                    Couleur (KBleu);
-                    cout << KTokenCoin;
-                    Couleur (KReset);
-                    cout << '|';
-                }
-                else{
-                    cout << KEmpty;
-                    cout << '|';
-                }
-            }
-            cout << endl;
+        const unsigned place (it->second);
+        const size_t   last  (VPosCoin.cells.back ());
+        VPosCoin.slot.erase (it);
+        VPosCoin.cells.pop_back ();
+        if (last != cell){
+            VPosCoin.cells [place] = last;
+            VPosCoin.slot  [last]  = place;
         }
-        cout << endl << endl;
-    } // ShowMatrix ()
+        coinPlane.Clear (cell);
+        if (!VPosCoin.VBlock.empty ()) --VPosCoin.VBlock [CoinBlock (VPosCoin, cell, mat.side)];
+        if (mat.cells [cell] == KTokenCoin) mat.cells [cell] = KEmpty;
+        return true;
+    } // RemoveCoin ()
 
     /*!
-     * \brief Deplace le joueur, teste la validité et la possibilité du déplacement.
-     * \param[in-out] mat matrice initialisée, redimmensionnée et affichée à l'écran dans laquelle les joueurs vont se déplacer
-     * \param[in-out]caracère prenant une des valeurs présentes à coté de la matrice lors de l'affichage (Z,D,X,Q,A,E,C,W) et qui définira la déplacement du pion (en diagonale, en haut/bas, à gauche/droite)
-     * \param[in-out] pos Position dans le vecteur, est modifiée lors d'un déplacement
-     * \param[in] turn Tour actuel, 1 ou 2 pour le joueur 1 ou le joueur 2 respectivement.
-     * \param[in] VNameColor tableau de pairs (ici, couple de deux chaines de caractères) associant les joueurs (leur nom) à une couleur
-     * \param[in] playersCouple entier qui définit un "couple" de joueurs qui jouent dans un même duel
-     */
-    void MoveToken (CMatrix         & mat,
-                    char            & move,
-                    CPosition       & pos,
-                    const unsigned  & turn,
-                    const CVPairStr & VNameColor,
-                    const unsigned  & playersCouple,
-                    const unsigned  & matrixSize){
-						
-        //! Vérification de la validité du déplacement. Si le pion va sortir de la matrice, une nouvelle valeur de Move est demandée.
-        while ((move == 'Z' && pos.first  == 0)            ||
-               (move == 'D' && pos.second == matrixSize-1) ||
-               (move == 'X' && pos.first  == matrixSize-1) ||
-               (move == 'Q' && pos.second == 0)            ||
-               (move == 'A' && pos.first  == 0)            ||
-               (move == 'A' && pos.second == 0)            ||
-               (move == 'E' && pos.first  == 0)            ||
-               (move == 'E' && pos.second == matrixSize-1) ||
-               (move == 'C' && pos.first  == matrixSize-1) ||
-               (move == 'C' && pos.second == matrixSize-1) ||
-               (move == 'W' && pos.first  == matrixSize-1) ||
-               (move == 'W' && pos.second == 0)            ||
-               (move == 'z' && pos.first  == 0)            ||
-               (move == 'd' && pos.second == matrixSize-1) ||
-               (move == 'x' && pos.first  == matrixSize-1) ||
-               (move == 'q' && pos.second == 0)            ||
-               (move == 'a' && pos.first  == 0)            ||
-               (move == 'a' && pos.second == 0)            ||
-               (move == 'e' && pos.first  == 0)            ||
-               (move == 'e' && pos.second == matrixSize-1) ||
-               (move == 'c' && pos.first  == matrixSize-1) ||
-               (move == 'c' && pos.second == matrixSize-1) ||
-               (move == 'w' && pos.first  == matrixSize-1) ||
-               (move == 'w' && pos.second == 0)){
-            cout << "Deplacement impossible." << endl;
-            ShowPrompt (move);
-        }
-
-        //! Autre vérification. Si la valeur de Move ne correspondant à l'une des options possibles, une nouvelle valeur est demandée.
-        while ((move != 'A') &&
-               (move != 'Z') &&
-               (move != 'E') &&
-               (move != 'Q') &&
-               (move != 'D') &&
-               (move != 'W') &&
-               (move != 'X') &&
-               (move != 'C') &&
-               (move != 'a') &&
-               (move != 'z') &&
-               (move != 'e') &&
-               (move != 'q') &&
-               (move != 'd') &&
-               (move != 'w') &&
-               (move != 'x') &&
-               (move != 'c')){
-            cout << "Saisie incorrecte." << endl;
-            ShowPrompt (move);
-        }
-
-        //! Modifie les coordonnées du pion en fonction du déplacement exigé.
-        mat[pos.first][pos.second] = KEmpty;
+     * \fn CPosition CellPosition (const size_t & cell, const unsigned & matrixSize)
+     * \brief Coordonnées dans la grille d'un indice de case des plans d'occupation.
+     */
+    inline CPosition CellPosition (const size_t & cell, const unsigned & matrixSize){
+        return make_pair (unsigned (cell / matrixSize), unsigned (cell % matrixSize));
+    } // CellPosition ()
 
-        switch (move){
-            case 'A' :
-                pos = make_pair(pos.first-1, pos.second-1);
-                break;
-            case 'Z' :
-                pos = make_pair(pos.first-1, pos.second);
-                break;
-            case 'E' :
-                pos = make_pair(pos.first-1, pos.second+1);
-                break;
-            case 'Q' :
-                pos = make_pair(pos.first, pos.second-1);
-                break;
-            case 'D' :
-                pos = make_pair(pos.first, pos.second+1);
-                break;
-            case 'W' :
-                pos = make_pair(pos.first+1, pos.second-1);
-                break;
-            case 'X' :
-                pos = make_pair(pos.first+1, pos.second);
-                break;
-            case 'C' :
-                pos = make_pair(pos.first+1, pos.second+1);
-                break;
-            case 'a' :
-                pos = make_pair(pos.first-1, pos.second-1);
-                break;
-            case 'z' :
-                pos = make_pair(pos.first-1, pos.second);
-                break;
-            case 'e' :
-                pos = make_pair(pos.first-1, pos.second+1);
-                break;
-            case 'q' :
-                pos = make_pair(pos.first, pos.second-1);
-                break;
-            case 'd' :
-                pos = make_pair(pos.first, pos.second+1);
-                break;
-            case 'w' :
-                pos = make_pair(pos.first+1, pos.second-1);
-                break;
-            case 'x' :
-                pos = make_pair(pos.first+1, pos.second);
-                break;
-            case 'c' :
-                pos = make_pair(pos.first+1, pos.second+1);
-                break;
+    /*!
+     * \fn void FramePut (CFrame & frame, const string & text, const string & coul)
+     * \brief Ajoute du texte en couleur à la fin d'une image. '\n' commence une nouvelle ligne et '\t' avance à la colonne multiple de 8 suivante.
+     */
+    void FramePut (CFrame & frame, const string & text, const string & coul){
+        const unsigned char color (ColorCode (coul));
+        if (frame.empty ()) frame.resize (1);
+        for (unsigned i(0); i < text.size ();){
+            if (text [i] == '\n'){
+                frame.push_back (CFrameLine ());
+                ++i;
+                continue;
+            }
+            CCell cell;
+            cell.color = color;
+            if (text [i] == '\t'){
+                cell.glyph [0] = ' ';
+                cell.size = 1;
+                do frame.back ().push_back (cell); while (frame.back ().size () % 8 != 0);
+                ++i;
+                continue;
+            }
+            //! Un caractère UTF-8 occupe une seule case même s'il fait plusieurs octets.
+            const unsigned char lead (text [i]);
+            cell.size = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+            for (unsigned k(0); k < cell.size; ++k)
+                cell.glyph [k] = (i + k < text.size ()) ? text [i + k] : ' ';
+            frame.back ().push_back (cell);
+            i += cell.size;
         }
-        mat[pos.first][pos.second] = ((turn == 1) ? (TokenPlayer1) : (TokenPlayer2));
-    } // MoveToken ()
+    } // FramePut ()
 
     /*!
-     * \fn CVPairStr InitPlayers (const unsigned & mode)
-     * \brief Initialise le vecteur contenant les pseudos des joueurs avec leur couleur.
+     * \fn void FramePutCell (CFrameLine & line, const char & glyph, const unsigned char & color)
+     * \brief Ajoute une case d'un seul octet à la fin d'une ligne d'image.
      */
-    CVPairStr InitPlayers (const unsigned & mode){
-        ClearScreen();
-
-        unsigned nb (1);
-        string name, color;
-        CVPairStr VNameColor;
+    void FramePutCell (CFrameLine & line, const char & glyph, const unsigned char & color){
+        CCell cell;
+        cell.glyph [0] = glyph;
+        cell.size  = 1;
+        cell.color = color;
+        line.push_back (cell);
+    } // FramePutCell ()
 
-        //! Mode duel.
-        if (mode == 1){
-            //! L'utilisateur entre le nom et choisit la couleur des deux seuls joueurs.
-            for (;nb < 3; ++nb){
-                ClearScreen();
-                cout << "Nom du joueur " << nb << " : ";
-                cin >> name;
+    /*!
+     * \fn bool SameCell (const CCell & a, const CCell & b)
+     * \brief Indique si deux cases s'affichent à l'identique.
+     */
+    bool SameCell (const CCell & a, const CCell & b){
+        return a.color == b.color && a.size == b.size && equal (a.glyph, a.glyph + a.size, b.glyph);
+    } // SameCell ()
 
-                cout << endl;
-                cout << "Saisir le caractère qui sera le pion du joueur " << ((nb == 1) ? ("1") : ("2")) << " : ";
-                cin >> ((nb == 1) ? (TokenPlayer1) : (TokenPlayer2));
+    /*!
+     * \fn void RenderFrame (const CFrame & previous, const CFrame & frame, string & out)
+     * \brief Ajoute à out les séquences qui transforment l'image previous affichée à l'écran en l'image frame.
+     * Seules les cases modifiées sont envoyées, précédées d'un positionnement du curseur. Le curseur est laissé à la fin de la dernière ligne et le reste de l'écran est effacé.
+     */
+    void RenderFrame (const CFrame & previous, const CFrame & frame, string & out){
+        const CFrameLine KNoLine;
+        //! 255 : couleur inconnue, la première case envoyée fixe toujours la couleur.
+        unsigned char current (255);
 
-                cout << endl;
-                ColorChoose (color);
+        for (unsigned row(0); row < max (previous.size (), frame.size ()); ++row){
+            const CFrameLine & oldLine (row < previous.size () ? previous [row] : KNoLine);
+            const CFrameLine & newLine (row < frame.size ()    ? frame [row]    : KNoLine);
+            bool cursorHere (false);
 
-                CPairString NameColor = make_pair (name, color);
-                VNameColor.push_back (NameColor);
+            for (unsigned col(0); col < newLine.size (); ++col){
+                if (col < oldLine.size () && SameCell (oldLine [col], newLine [col])){
+                    cursorHere = false;
+                    continue;
+                }
+                if (!cursorHere){
+                    out += "\033[" + to_string (row + 1) + ';' + to_string (col + 1) + 'H';
+                    cursorHere = true;
+                }
+                if (newLine [col].color != current){
+                    current = newLine [col].color;
+                    out += "\033[" + to_string (current) + 'm';
+                }
+                out.append (newLine [col].glyph, newLine [col].size);
+            }
+            //! La ligne a raccourci : on efface la fin de l'ancienne.
+            if (oldLine.size () > newLine.size ()){
+                if (current != 0){
+                    current = 0;
+                    out += "\033[0m";
+                }
+                out += "\033[" + to_string (row + 1) + ';' + to_string (newLine.size () + 1) + "H\033[K";
             }
         }
+        if (current != 0 && current != 255)
+            out += "\033[0m";
+        const unsigned lastRow (frame.empty () ? 1 : frame.size ());
+        const unsigned lastCol (frame.empty () ? 1 : frame.back ().size () + 1);
+        out += "\033[" + to_string (lastRow) + ';' + to_string (lastCol) + "H\033[J";
+    } // RenderFrame ()
 
-        //! Mode Multijoueur.
-        else if (mode == 2){
-            unsigned nbPlayers;
-            cout << "Saisir le nombre de joueurs : ";
-            ShowPrompt (nbPlayers);
-
-            while (nbPlayers % 2 != 0){
-                cout << "Veuillez saisir un nombre pair de joueurs : ";
-                ShowPrompt (nbPlayers);
+    /*!
+     * \fn bool WriteAll (const string & buffer, const int & fd = STDOUT_FILENO)
+     * \brief Envoie buffer en un seul appel à write () si possible. Vers le terminal, cout est vidé avant pour conserver l'ordre d'affichage.
+     * \return false si l'écriture a échoué.
+     */
+    bool WriteAll (const string & buffer, const int & fd = STDOUT_FILENO){
+        if (fd == STDOUT_FILENO) cout.flush ();
+        for (size_t done (0); done < buffer.size ();){
+            ssize_t written = write (fd, buffer.data () + done, buffer.size () - done);
+            if (written < 0){
+                if (errno == EINTR) continue;
+                return false;
             }
+            done += written;
+        }
+        return true;
+    } // WriteAll ()
 
-            while (VNameColor.size() < nbPlayers){
+    //! Lignes de l'image au-dessus de la grille (déplacements, pseudos, score) et lignes à garder en dessous (tours restants, invite, messages).
+    const unsigned KFrameHeaderRows = 11;
+    const unsigned KFrameFooterRows = 7;
+    //! Hauteur maximale de la minicarte, bordure comprise.
+    const unsigned KMinimapRows     = 18;
+    //! Taille supposée d'un terminal dont on ne connait pas la taille (clients du serveur).
+    const unsigned KDefaultTermRows = 24;
+    const unsigned KDefaultTermCols = 80;
+
+    /*!
+     * \struct CViewport
+     * \brief Partie de la grille affichée par ComposeMatrix () et minicarte de toute la grille, quand la grille ne tient pas dans le terminal.
+     */
+    struct CViewport {
+        //! Première ligne et première colonne affichées, nombre de lignes et de colonnes affichées.
+        unsigned top;
+        unsigned left;
+        unsigned nbRows;
+        unsigned nbCols;
+        //! Cases de la minicarte (sans la bordure), 0 sans minicarte. Chacune résume un bloc de la grille.
+        unsigned mapRows;
+        unsigned mapCols;
+    };
+
+    /*!
+     * \fn bool TerminalSize (unsigned & rows, unsigned & cols)
+     * \brief Taille du terminal de la sortie standard. Renvoie false si ce n'est pas un terminal.
+     */
+    bool TerminalSize (unsigned & rows, unsigned & cols){
+        winsize size;
+        if (ioctl (STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0) return false;
+        rows = size.ws_row;
+        cols = size.ws_col;
+        return true;
+    } // TerminalSize ()
+
+    /*!
+     * \fn CViewport FitViewport (const unsigned & side, const CPosition & pos, const unsigned & termRows, const unsigned & termCols)
+     * \brief Choisit la fenêtre d'une grille side x side à afficher dans un terminal de termRows x termCols (0 : sans limite).
+     * Si la grille tient, elle est affichée en entier. Sinon la fenêtre est centrée sur pos, la position du joueur dont c'est le tour, et une minicarte est placée à sa droite.
+     */
+    CViewport FitViewport (const unsigned & side, const CPosition & pos, const unsigned & termRows, const unsigned & termCols){
+        CViewport view = {0, 0, side, side, 0, 0};
+        if (termRows == 0 || termCols == 0) return view;
+        const unsigned rows (max (termRows, KFrameHeaderRows + KFrameFooterRows + 3) - KFrameHeaderRows - KFrameFooterRows);
+        if (side <= rows && 2 * side + 1 <= termCols) return view;
+
+        //! La minicarte garde des blocs à peu près carrés à l'écran : deux colonnes par ligne.
+        view.nbRows  = min (side, rows);
+        view.mapRows = (view.nbRows >= 5) ? min (side, min (view.nbRows, KMinimapRows) - 2) : 0;
+        view.mapCols = min (side, 2 * view.mapRows);
+        //! Une case de la grille prend deux colonnes ; la minicarte, sa bordure et deux espaces prennent mapCols + 4 colonnes.
+        const unsigned mapWidth (view.mapRows ? view.mapCols + 4 : 0);
+        if (termCols < mapWidth + 2 * 8 + 1) view.mapRows = view.mapCols = 0;
+        view.nbCols = min (side, max ((termCols - 1 - (view.mapRows ? mapWidth : 0)) / 2, 1u));
+
+        //! La fenêtre suit le joueur dont c'est le tour, sans sortir de la grille.
+        view.top  = min (pos.first  - min (pos.first,  view.nbRows / 2), side - view.nbRows);
+        view.left = min (pos.second - min (pos.second, view.nbCols / 2), side - view.nbCols);
+        return view;
+    } // FitViewport ()
+
+    /*!
+     * \fn void InitMinimap (vector<CCell> & VMap, const uint64_t & side, const CViewport & view)
+     * \brief Minicarte vide d'une grille side x side : ':' pour les blocs de la fenêtre affichée, '.' pour les autres.
+     */
+    void InitMinimap (vector<CCell> & VMap, const uint64_t & side, const CViewport & view){
+        CCell cell;
+        cell.size  = 1;
+        cell.color = 0;
+        cell.glyph [0] = '.';
+        VMap.assign (view.mapRows * view.mapCols, cell);
+        for (unsigned r (view.top * view.mapRows / side); r <= (view.top + view.nbRows - 1) * view.mapRows / side; ++r)
+            for (unsigned c (view.left * view.mapCols / side); c <= (view.left + view.nbCols - 1) * view.mapCols / side; ++c)
+                VMap [r * view.mapCols + c].glyph [0] = ':';
+    } // InitMinimap ()
+
+    /*!
+     * \fn void MarkMinimap (vector<CCell> & VMap, const uint64_t & side, const CViewport & view, const CPosition & pos, const char & glyph, const unsigned char & color)
+     * \brief Affiche glyph dans le bloc de la minicarte qui contient pos, à la place de ce qu'il montrait.
+     */
+    void MarkMinimap (vector<CCell> & VMap, const uint64_t & side, const CViewport & view, const CPosition & pos, const char & glyph, const unsigned char & color){
+        CCell & block (VMap [pos.first * view.mapRows / side * view.mapCols + pos.second * view.mapCols / side]);
+        block.glyph [0] = glyph;
+        block.color     = color;
+    } // MarkMinimap ()
+
+    /*!
+     * \fn void MarkCoinBlocks (vector<CCell> & VMap, CCoinStore & VPosCoin, const uint64_t & side, const CViewport & view, const unsigned char & color)
+     * \brief Affiche une pièce dans chaque bloc de la minicarte qui en contient au moins une.
+     */
+    void MarkCoinBlocks (vector<CCell> & VMap, CCoinStore & VPosCoin, const uint64_t & side, const CViewport & view, const unsigned char & color){
+        CountCoinBlocks (VPosCoin, side, view.mapRows, view.mapCols);
+        for (size_t block(0); block < VMap.size (); ++block)
+            if (VPosCoin.VBlock [block]){
+                VMap [block].glyph [0] = KTokenCoin;
+                VMap [block].color     = color;
+            }
+    } // MarkCoinBlocks ()
+
+    /*!
+     * \fn void ComposeMinimap (vector<CCell> & VMap, CGameState & game, const CViewport & view, const unsigned char VColor [4])
+     * \brief Réduit toute la grille en view.mapRows x view.mapCols blocs : un bloc montre le plus important des pions qu'il contient
+     * (joueur, puis carré rouge, puis pièce), ':' s'il est dans la fenêtre affichée et '.' sinon.
+     * Les pièces sont lues dans les compteurs par bloc de VPosCoin : le coût dépend de la taille de la minicarte, pas de la grille ni du nombre de pièces.
+     * \param VColor couleurs du joueur 1, du joueur 2, du carré rouge et des pièces.
+     */
+    void ComposeMinimap (vector<CCell> & VMap, CGameState & game, const CViewport & view, const unsigned char VColor [4]){
+        const uint64_t side (game.mat.side);
+        InitMinimap (VMap, side, view);
+
+        //! Les pions sont posés par importance croissante : le dernier posé sur un bloc est celui qui reste visible.
+        MarkCoinBlocks (VMap, game.VPosCoin, side, view, VColor [3]);
+        if (!game.doesRedSquare)
+            MarkMinimap (VMap, side, view, game.posRedSquare, KTokenRedSquare, VColor [2]);
+        MarkMinimap (VMap, side, view, game.posPlayer2, TokenPlayer2, VColor [1]);
+        MarkMinimap (VMap, side, view, game.posPlayer1, TokenPlayer1, VColor [0]);
+    } // ComposeMinimap ()
+
+    /*!
+     * \fn void ComposeMinimapLine (CFrameLine & line, const vector<CCell> & VMap, const CViewport & view, const unsigned & mapLine)
+     * \brief Ajoute à la ligne mapLine de la fenêtre la ligne correspondante de la minicarte, encadrée : elle occupe les premières lignes à droite de la fenêtre.
+     */
+    void ComposeMinimapLine (CFrameLine & line, const vector<CCell> & VMap, const CViewport & view, const unsigned & mapLine){
+        if (!view.mapRows || mapLine >= view.mapRows + 2) return;
+        FramePutCell (line, ' ', 0);
+        FramePutCell (line, ' ', 0);
+        const bool border (mapLine == 0 || mapLine == view.mapRows + 1);
+        FramePutCell (line, border ? '+' : '|', 0);
+        for (unsigned c(0); c < view.mapCols; ++c)
+            if (border)
+                FramePutCell (line, '-', 0);
+            else
+                line.push_back (VMap [(mapLine - 1) * view.mapCols + c]);
+        FramePutCell (line, border ? '+' : '|', 0);
+    } // ComposeMinimapLine ()
+
+    /*!
+     * \fn void ComposeMoveHelp (CFrame & frame)
+     * \brief Ajoute à l'image le dessin des touches de déplacement, en tête de chaque écran de jeu.
+     */
+    void ComposeMoveHelp (CFrame & frame){
+        FramePut (frame, "\t# Deplacements\n", KBleu);
+        //! Affiche un dessin explicitant les déplacement possibles, correspondant aux lettres.
+        FramePut (frame, "\t A   Z   E\n\t     ^\n\tQ  < o >  D \n\t     v\n\t W   X   C\n\n", KReset);
+    } // ComposeMoveHelp ()
+
+    /*!
+     * \fn void ComposeMatrix (CFrame & frame, CGameState & game, const CVPairStr & VNameColor, const unsigned & playersCouple, const bool & showTurn, const unsigned & termRows, const unsigned & termCols)
+     * \brief Construit l'image de la matrice et de son contenu, telle que ShowMatrix l'affiche.
+     * \param showTurn ajoute le nombre de tours restants et le joueur qui doit jouer.
+     * \param termRows, termCols taille du terminal (0 : sans limite). Une grille plus grande est affichée par une fenêtre et une minicarte (FitViewport ()) :
+     * le coût de l'image dépend alors de la taille du terminal, plus de celle de la grille ni du nombre de pièces.
+     * game n'est modifié que par les compteurs de pièces de la minicarte (CountCoinBlocks ()).
+     */
+    void ComposeMatrix (CFrame & frame, CGameState & game, const CVPairStr & VNameColor, const unsigned & playersCouple, const bool & showTurn, const unsigned & termRows, const unsigned & termCols){
+        const CMatrix & mat (game.mat);
+        const unsigned char colorPlayer1 (ColorCode (VNameColor [playersCouple].second));
+        const unsigned char colorPlayer2 (ColorCode (VNameColor [playersCouple + 1].second));
+        const unsigned char colorRouge   (stoi (KRouge));
+        const unsigned char colorBleu    (stoi (KBleu));
+        const CViewport view (FitViewport (mat.side, game.turn == 1 ? game.posPlayer1 : game.posPlayer2, termRows, termCols));
+
+        frame.assign (1, CFrameLine ());
+        ComposeMoveHelp (frame);
+
+        //! Affiche les pseudos en couleur des joueurs qui s'affrontent.
+        FramePut (frame, "\n\t", KReset);
+        FramePut (frame, VNameColor [playersCouple].first, VNameColor [playersCouple].second);
+        FramePut (frame, "\t\tvs.\t\t", KReset);
+        FramePut (frame, VNameColor [playersCouple + 1].first, VNameColor [playersCouple + 1].second);
+
+        //! Affiche leur score actuel.
+        FramePut (frame, "\nScore : ", KBleu);
+        FramePut (frame, to_string (game.VScore [0]), VNameColor [playersCouple].second);
+        FramePut (frame, "\t\t/\t\t", KReset);
+        FramePut (frame, to_string (game.VScore [1]), VNameColor [playersCouple + 1].second);
+        if (view.nbRows == mat.side && view.nbCols == mat.side)
+            FramePut (frame, "\n\n\n", KReset);
+        else
+            FramePut (frame, "\nLignes " + to_string (view.top + 1) + " à " + to_string (view.top + view.nbRows) + ", colonnes " + to_string (view.left + 1) + " à " + to_string (view.left + view.nbCols) + " sur " + to_string (mat.side) + "\n\n", KReset);
+
+        //! Propre à chaque image : les boucles du serveur composent leurs grilles en même temps.
+        vector<CCell> VMap;
+        if (view.mapRows){
+            const unsigned char VColor [4] = {colorPlayer1, colorPlayer2, colorRouge, colorBleu};
+            ComposeMinimap (VMap, game, view, VColor);
+        }
+        for (unsigned i (view.top); i < view.top + view.nbRows; ++i){
+            CFrameLine & line (frame.back ());
+            const char * row (mat.Row (i));
+            line.reserve (2 * view.nbCols + 1 + (view.mapRows ? view.mapCols + 4 : 0));
+            FramePutCell (line, '|', 0);
+            for (unsigned j (view.left); j < view.left + view.nbCols; ++j){
+                //! Quand les coordonnées [i][j] correspondent aux coordonnées des pions des joueurs ou du carré rouge, celui-ci est affiché de la bonne couleur. Sinon la case affichée est vide.
+                if (row[j] == TokenPlayer1)
+                    FramePutCell (line, TokenPlayer1, colorPlayer1);
+                else if (row[j] == TokenPlayer2)
+                    FramePutCell (line, TokenPlayer2, colorPlayer2);
+                else if (row[j] == KTokenRedSquare)
+                    FramePutCell (line, KTokenRedSquare, colorRouge);
+                else if (row[j] == KTokenCoin)
+                    FramePutCell (line, KTokenCoin, colorBleu);
+                else
+                    FramePutCell (line, KEmpty, 0);
+                FramePutCell (line, '|', 0);
+            }
+            ComposeMinimapLine (line, VMap, view, i - view.top);
+            frame.push_back (CFrameLine ());
+        }
+        FramePut (frame, "\n\n", KReset);
+
+        if (showTurn){
+            //! '1' tour n'est pas pluriel, vérification pour affichage correct.
+            FramePut (frame, to_string (game.compteTour), KBleu);
+            FramePut (frame, ((game.compteTour != 1) ? (" tours restants\n") : (" tour restant\n")), KReset);
+
+            //! Le prompt affiché est le bon pseudo de la bonne couleur.
+            FramePut (frame, "C'est à ", KReset);
+            FramePut (frame, VNameColor [playersCouple + game.turn - 1].first + " ", VNameColor [playersCouple + game.turn - 1].second);
+            FramePut (frame, "de jouer :\n", KReset);
+        }
+    } // ComposeMatrix ()
+
+    /*!
+     * \fn void ShowMatrix (CGameState & game, const CVPairStr & VNameColor, const unsigned & playersCouple, const bool & showTurn)
+     * \brief Affiche la matrice et son contenu à l'écran.
+     * \param playersCouple est un entier qui définit un "couple" de joueurs qui s'affrontent. VNameColor à l'indice playersCouple correspond au joueur 1 et l'indice playersCouple+1 au joueur 2.
+     * Seules les cases qui ont changé depuis l'image précédente sont envoyées, en un seul write (). Après un ClearScreen () tout est redessiné.
+     */
+    void ShowMatrix (CGameState & game, const CVPairStr & VNameColor, const unsigned & playersCouple, const bool & showTurn){
+        static CFrame frame;
+        static string buffer;
+        static unsigned lastRows (0), lastCols (0);
+        const uint64_t start (ProbeStart (game.telemetry));
+
+        //! Hors d'un terminal, la grille est écrite en entier. Si le terminal a changé de taille, son contenu a été remis en page : tout est redessiné.
+        unsigned termRows (0), termCols (0);
+        TerminalSize (termRows, termCols);
+        if (termRows != lastRows || termCols != lastCols) ScreenFrame.clear ();
+        lastRows = termRows;
+        lastCols = termCols;
+
+        ComposeMatrix (frame, game, VNameColor, playersCouple, showTurn, termRows, termCols);
+        //! Sans image précédente, le contenu de l'écran est inconnu : on l'efface avant de tout redessiner.
+        buffer.assign (ScreenFrame.empty () ? "\033[H\033[2J" : "");
+        RenderFrame (ScreenFrame, frame, buffer);
+        WriteAll (buffer);
+        ScreenFrame.swap (frame);
+        ProbeStop (game.telemetry, KProbeRender, start);
+        AddCounter (game.telemetry, KCounterBytes, buffer.size ());
+    } // ShowMatrix ()
+
+    /*!
+     * \struct CMoveDelta
+     * \brief Déplacement associé à une touche : décalage en ligne (dx) et en colonne (dy), et indice de la direction dans KMoveKeys.
+     */
+    struct CMoveDelta {
+        signed char   dx;
+        signed char   dy;
+        unsigned char dir;
+        bool          valid;
+    };
+
+    /*!
+     * \struct CMoveTable
+     * \brief Table des 256 valeurs possibles d'une touche.
+     */
+    struct CMoveTable {
+        CMoveDelta entry [256];
+    };
+
+    //! Les touches de déplacement, dans l'ordre des bits de LegalMoves ().
+    constexpr char KMoveKeys [] = "AZEQDWXC";
+
+    /*!
+     * \fn constexpr CMoveTable MakeMoveTable ()
+     * \brief Construit à la compilation la table touche -> déplacement. Majuscules et minuscules donnent le même déplacement, toutes les autres touches sont invalides.
+     */
+    constexpr CMoveTable MakeMoveTable (){
+        const signed char dx [] = {-1, -1, -1,  0, 0,  1, 1, 1};
+        const signed char dy [] = {-1,  0,  1, -1, 1, -1, 0, 1};
+        CMoveTable table {};
+        for (unsigned k(0); k < 8; ++k){
+            const CMoveDelta delta {dx [k], dy [k], (unsigned char) k, true};
+            table.entry [(unsigned char) KMoveKeys [k]]                    = delta;
+            table.entry [(unsigned char) (KMoveKeys [k] - 'A' + 'a')] = delta;
+        }
+        return table;
+    } // MakeMoveTable ()
+
+    constexpr CMoveTable KMoveTable = MakeMoveTable ();
+
+    /*!
+     * \fn TStepStatus CheckMove (const char & move, const CPosition & pos, const unsigned & matrixSize)
+     * \brief Teste la validité et la possibilité du déplacement, sans rien afficher.
+     * \param[in] move caractère prenant une des valeurs présentes à coté de la matrice lors de l'affichage (Z,D,X,Q,A,E,C,W)
+     * \param[in] pos Position actuelle du pion
+     * \return KStepOk si le déplacement est possible, KStepBadKey ou KStepOutOfBoard sinon.
+     */
+    TStepStatus CheckMove (const char & move, const CPosition & pos, const unsigned & matrixSize){
+        const CMoveDelta & delta (KMoveTable.entry [(unsigned char) move]);
+        if (!delta.valid) return KStepBadKey;
+
+        //! Une coordonnée qui passe sous 0 devient très grande en non signé : un seul test par coordonnée suffit.
+        if (pos.first + delta.dx >= matrixSize || pos.second + delta.dy >= matrixSize)
+            return KStepOutOfBoard;
+
+        return KStepOk;
+    } // CheckMove ()
+
+    /*!
+     * \fn unsigned LegalMoves (const CPosition & pos, const unsigned & matrixSize)
+     * \brief Masque des déplacements possibles depuis pos : le bit k est à 1 si KMoveKeys [k] reste dans la matrice.
+     */
+    unsigned LegalMoves (const CPosition & pos, const unsigned & matrixSize){
+        unsigned mask (0);
+        for (unsigned k(0); k < 8; ++k){
+            const CMoveDelta & delta (KMoveTable.entry [(unsigned char) KMoveKeys [k]]);
+            if (pos.first + delta.dx < matrixSize && pos.second + delta.dy < matrixSize)
+                mask |= 1u << k;
+        }
+        return mask;
+    } // LegalMoves ()
+
+    /*!
+     * \fn CPosition Destination (const char & move, const CPosition & pos)
+     * \brief Calcule la case atteinte par un déplacement, sans modifier la matrice. Le déplacement doit avoir été validé par CheckMove ().
+     */
+    CPosition Destination (const char & move, const CPosition & pos){
+        const CMoveDelta & delta (KMoveTable.entry [(unsigned char) move]);
+        return make_pair (pos.first + delta.dx, pos.second + delta.dy);
+    } // Destination ()
+
+    /*!
+     * \fn void ApplyMove (CMatrix & mat, const char & move, CPosition & pos, const char & token)
+     * \brief Deplace le pion dans la matrice. Le déplacement doit avoir été validé par CheckMove ().
+     * \param[in-out] mat matrice dans laquelle les joueurs se déplacent
+     * \param[in-out] pos Position dans la matrice, est modifiée par le déplacement
+     * \param[in] token pion à replacer à la nouvelle position
+     */
+    void ApplyMove (CMatrix & mat, const char & move, CPosition & pos, const char & token){
+        //! Modifie les coordonnées du pion en fonction du déplacement exigé.
+        mat[pos] = KEmpty;
+
+        pos = Destination (move, pos);
+        mat[pos] = token;
+    } // ApplyMove ()
+
+    /*!
+     * \fn TPlayerKind KindChoose ()
+     * \brief Demande si le joueur est un humain ou l'ordinateur.
+     */
+    TPlayerKind KindChoose (){
+        unsigned kind;
+        cout << "1. Humain" << endl << "2. Ordinateur (alpha-bêta)" << endl << "3. Ordinateur (Monte-Carlo)" << endl;
+        ShowPrompt (kind);
+
+        while (kind < 1 || kind > 3){
+            cout << "Saisie incorrecte." << endl;
+            ShowPrompt (kind);
+        }
+        cout << endl;
+        return (kind == 1) ? KHuman : (kind == 2) ? KComputerSearch : KComputerMcts;
+    } // KindChoose ()
+
+    /*!
+     * \fn TTournament FormatChoose ()
+     * \brief Demande la formule du tournoi multijoueur.
+     */
+    TTournament FormatChoose (){
+        unsigned format;
+        cout << "Formule du tournoi :" << endl << "1. Élimination directe" << endl << "2. Système suisse" << endl;
+        ShowPrompt (format);
+
+        while (format < 1 || format > 2){
+            cout << "Saisie incorrecte." << endl;
+            ShowPrompt (format);
+        }
+        cout << endl;
+        return (format == 1) ? KKnockout : KSwiss;
+    } // FormatChoose ()
+
+    /*!
+     * \fn CVPairStr ComputerPlayers (const unsigned & nbPlayers, const unsigned & first)
+     * \brief Noms et couleurs de nbPlayers joueurs ordinateur, numérotés à partir de first. Les couleurs sont prises tour à tour.
+     */
+    CVPairStr ComputerPlayers (const unsigned & nbPlayers, const unsigned & first){
+        const string VColor [] = {KRouge, KVert, KJaune, KBleu, KMagenta, KCyan};
+        CVPairStr VNameColor;
+        for (unsigned i(0); i < nbPlayers; ++i)
+            VNameColor.push_back (make_pair ("Ordinateur" + to_string (first + i), VColor [(first + i) % 6]));
+        return VNameColor;
+    } // ComputerPlayers ()
+
+    /*!
+     * \fn CVPairStr InitPlayers (const unsigned & mode, const unsigned & matrixSize, vector<TPlayerKind> & VKind)
+     * \brief Initialise le vecteur contenant les pseudos des joueurs avec leur couleur, et VKind qui indique qui joue pour chacun d'eux.
+     * \param matrixSize taille de la grille : une mêlée a moins de joueurs que de cases.
+     */
+    CVPairStr InitPlayers (const unsigned & mode, const unsigned & matrixSize, vector<TPlayerKind> & VKind){
+        ClearScreen();
+        VKind.clear ();
+
+        unsigned nb (1);
+        string name, color;
+        CVPairStr VNameColor;
+
+        //! Mode duel.
+        if (mode == 1){
+            //! L'utilisateur entre le nom et choisit la couleur des deux seuls joueurs.
+            for (;nb < 3; ++nb){
+                ClearScreen();
+                cout << "Joueur " << nb << " :" << endl;
+                VKind.push_back (KindChoose ());
+                if (VKind.back () == KHuman){
+                    cout << "Nom du joueur " << nb << " : ";
+                    cin >> name;
+                }
+                else
+                    name = "Ordinateur" + to_string (nb);
+
+                cout << endl;
+                cout << "Saisir le caractère qui sera le pion du joueur " << ((nb == 1) ? ("1") : ("2")) << " : ";
+                cin >> ((nb == 1) ? (TokenPlayer1) : (TokenPlayer2));
+
+                cout << endl;
+                ColorChoose (color);
+
+                CPairString NameColor = make_pair (name, color);
+                VNameColor.push_back (NameColor);
+            }
+        }
+
+        //! Mode Multijoueur.
+        else if (mode == 2){
+            unsigned nbPlayers;
+            cout << "Saisir le nombre de joueurs : ";
+            ShowPrompt (nbPlayers);
+
+            //! Le tournoi exempte un joueur à chaque ronde quand ils sont en nombre impair.
+            while (nbPlayers < 2){
+                cout << "Veuillez saisir au moins 2 joueurs : ";
+                ShowPrompt (nbPlayers);
+            }
+
+            while (VNameColor.size() < nbPlayers){
+                ClearScreen();
+                cout << "Joueur " << nb << " :" << endl;
+                VKind.push_back (KindChoose ());
+                if (VKind.back () == KHuman){
+                    cout << "Nom du joueur " << nb << " : ";
+                    cin >> name;
+                }
+                else
+                    name = "Ordinateur" + to_string (nb);
+
+                cout << endl;
+                ColorChoose (color);
+
+                CPairString NameColor = make_pair (name, color);
+                VNameColor.push_back (NameColor);
+
+                ++nb;
+            }
+        }
+
+        //! Mêlée : les joueurs humains se présentent, les joueurs ordinateur complètent la grille.
+        else if (mode == 3){
+            unsigned nbPlayers, nbHumans;
+            const uint64_t nbCells (uint64_t (matrixSize) * matrixSize);
+            cout << "Saisir le nombre de joueurs : ";
+            ShowPrompt (nbPlayers);
+            //! Chaque joueur est placé sur sa propre case.
+            while (nbPlayers < 2 || nbPlayers >= nbCells){
+                cout << "Veuillez saisir au moins 2 joueurs, et moins que les " << nbCells << " cases de la grille : ";
+                ShowPrompt (nbPlayers);
+            }
+            cout << "Dont joueurs humains : ";
+            ShowPrompt (nbHumans);
+            while (nbHumans > nbPlayers){
+                cout << "Veuillez saisir au plus " << nbPlayers << " joueurs humains : ";
+                ShowPrompt (nbHumans);
+            }
+
+            for (; nb <= nbHumans; ++nb){
                 ClearScreen();
-                cout << "Nom du joueur " << nb << " : ";
+                cout << "Joueur " << nb << " :" << endl << "Nom du joueur " << nb << " : ";
                 cin >> name;
+                cout << endl;
+                ColorChoose (color);
+                VNameColor.push_back (make_pair (name, color));
+                VKind.push_back (KHuman);
+            }
+            const CVPairStr VComputer (ComputerPlayers (nbPlayers - nbHumans, nb));
+            VNameColor.insert (VNameColor.end (), VComputer.begin (), VComputer.end ());
+            VKind.resize (nbPlayers, KComputerSearch);
+        }
+        return VNameColor;
+    } // InitPlayers ()
+
+    //! Journal binaire des parties, complété par SaveNames ().
+    const char KMatchLog [] = "Resultats.bin";
+    //! Signature et version du format du journal.
+    const char     KLogMagic [8] = {'C', 'M', 'I', 'Y', 'C', 'L', 'O', 'G'};
+    const uint32_t KLogVersion   = 1;
+
+    /*!
+     * \struct CLogHeader
+     * \brief En-tête du journal (16 octets) : signature, version et somme de contrôle des 12 premiers octets.
+     */
+    struct CLogHeader {
+        char     magic [8];
+        uint32_t version;
+        uint32_t checksum;
+    };
+
+    /*!
+     * \struct CLogRecord
+     * \brief Partie fixe d'un enregistrement (32 octets). Elle est précédée de la taille et de la somme de contrôle de l'enregistrement,
+     * et suivie des deux noms puis des coups, deux par octet (indice dans KMoveKeys, premier coup dans les 4 bits de poids faible).
+     */
+    struct CLogRecord {
+        uint64_t seed;
+        uint32_t matrixSize;
+        uint32_t score [2];
+        uint32_t nbMoves;
+        uint8_t  winner;
+        uint8_t  outcome;
+        uint8_t  nameLength [2];
+        uint32_t reserved;
+    };
+    static_assert (sizeof (CLogHeader) == 16 && sizeof (CLogRecord) == 32, "format du journal");
+
+    /*!
+     * \fn uint32_t Checksum (const char * data, const size_t & size)
+     * \brief Somme de contrôle FNV-1a sur 32 bits.
+     */
+    uint32_t Checksum (const char * data, const size_t & size){
+        uint32_t hash (2166136261u);
+        for (size_t i(0); i < size; ++i)
+            hash = (hash ^ (unsigned char) data [i]) * 16777619u;
+        return hash;
+    } // Checksum ()
+
+    /*!
+     * \fn void EncodeMatch (string & buffer, const CMatchResult & result)
+     * \brief Ajoute l'enregistrement d'une partie à la fin de buffer. Les noms sont tronqués à 255 octets.
+     */
+    void EncodeMatch (string & buffer, const CMatchResult & result){
+        CLogRecord record;
+        memset (&record, 0, sizeof (record));
+        record.seed       = result.seed;
+        record.matrixSize = result.matrixSize;
+        record.score [0]  = result.VScore [0];
+        record.score [1]  = result.VScore [1];
+        record.nbMoves    = result.VMove.size ();
+        record.winner     = result.winner;
+        record.outcome    = result.outcome;
+        record.nameLength [0] = min<size_t> (result.names [0].size (), 255);
+        record.nameLength [1] = min<size_t> (result.names [1].size (), 255);
+
+        string payload (reinterpret_cast<const char *> (&record), sizeof (record));
+        payload.append (result.names [0], 0, record.nameLength [0]);
+        payload.append (result.names [1], 0, record.nameLength [1]);
+        for (size_t i(0); i < result.VMove.size (); i += 2){
+            unsigned char packed (KMoveTable.entry [(unsigned char) result.VMove [i]].dir);
+            if (i + 1 < result.VMove.size ())
+                packed |= KMoveTable.entry [(unsigned char) result.VMove [i + 1]].dir << 4;
+            payload += char (packed);
+        }
+
+        const uint32_t head [2] = {uint32_t (payload.size ()), Checksum (payload.data (), payload.size ())};
+        buffer.append (reinterpret_cast<const char *> (head), sizeof (head));
+        buffer += payload;
+    } // EncodeMatch ()
+
+    /*!
+     * \fn bool DecodeMatch (const char * data, const size_t & available, CMatchResult & result, size_t & length)
+     * \brief Lit l'enregistrement d'une partie écrit par EncodeMatch () au début de data, dont available octets sont lisibles.
+     * \param length reçoit la taille de l'enregistrement, taille et somme de contrôle comprises.
+     * \return false si l'enregistrement est incomplet ou abîmé ; result n'est alors pas modifié.
+     */
+    bool DecodeMatch (const char * data, const size_t & available, CMatchResult & result, size_t & length){
+        uint32_t head [2];
+        if (available < sizeof (head)) return false;
+        memcpy (head, data, sizeof (head));
+        const char * payload (data + sizeof (head));
+
+        CLogRecord record;
+        if (head [0] < sizeof (record) || head [0] > available - sizeof (head)) return false;
+        memcpy (&record, payload, sizeof (record));
+        //! Les longueurs sont vérifiées avant la somme de contrôle, qui coûte un passage sur tout l'enregistrement.
+        if (sizeof (record) + record.nameLength [0] + record.nameLength [1] + (uint64_t (record.nbMoves) + 1) / 2 != head [0]
+            || record.winner > 2 || record.outcome > KOutcomeTime || Checksum (payload, head [0]) != head [1]) return false;
+        length = sizeof (head) + head [0];
+
+        const char * names (payload + sizeof (record));
+        result.names [0].assign (names, record.nameLength [0]);
+        result.names [1].assign (names + record.nameLength [0], record.nameLength [1]);
+        result.seed       = record.seed;
+        result.matrixSize = record.matrixSize;
+        result.VScore [0] = record.score [0];
+        result.VScore [1] = record.score [1];
+        result.winner     = record.winner;
+        result.outcome    = TOutcome (record.outcome);
+        const unsigned char * moves (reinterpret_cast<const unsigned char *> (names + record.nameLength [0] + record.nameLength [1]));
+        result.VMove.resize (record.nbMoves);
+        for (uint32_t i(0); i < record.nbMoves; ++i)
+            result.VMove [i] = KMoveKeys [(moves [i / 2] >> (4 * (i % 2))) & 7];
+        return true;
+    } // DecodeMatch ()
+
+    /*!
+     * \fn bool AppendMatchLog (const string & path, const vector<CMatchResult> & VResult)
+     * \brief Ajoute les parties à la fin du journal, en créant son en-tête s'il est vide. Un fichier qui n'est pas un journal n'est jamais modifié.
+     * Tous les enregistrements partent en un seul write () en mode O_APPEND.
+     */
+    bool AppendMatchLog (const string & path, const vector<CMatchResult> & VResult){
+        const int fd (open (path.c_str (), O_RDWR | O_APPEND | O_CREAT, 0644));
+        if (fd < 0) return false;
+
+        string buffer;
+        struct stat info;
+        CLogHeader header;
+        bool ok (fstat (fd, &info) == 0);
+        if (ok && info.st_size == 0){
+            memcpy (header.magic, KLogMagic, sizeof (header.magic));
+            header.version  = KLogVersion;
+            header.checksum = Checksum (reinterpret_cast<const char *> (&header), offsetof (CLogHeader, checksum));
+            buffer.assign (reinterpret_cast<const char *> (&header), sizeof (header));
+        }
+        else if (ok)
+            ok = pread (fd, &header, sizeof (header), 0) == ssize_t (sizeof (header)) && memcmp (header.magic, KLogMagic, sizeof (header.magic)) == 0
+              && header.version == KLogVersion && header.checksum == Checksum (reinterpret_cast<const char *> (&header), offsetof (CLogHeader, checksum));
+
+        for (const CMatchResult & result : VResult)
+            EncodeMatch (buffer, result);
+        ok = ok && WriteAll (buffer, fd);
+        close (fd);
+        return ok;
+    } // AppendMatchLog ()
+
+    /*!
+     * \fn bool ReadMatchLog (const string & path, const function<void (const CMatchResult &)> & visit, unsigned & nbCorrupt, size_t & offset)
+     * \brief Parcourt le journal projeté en mémoire par mmap () et appelle visit pour chaque partie dont la somme de contrôle est bonne.
+     * Les enregistrements abîmés sont comptés dans nbCorrupt et sautés.
+     * \param[in-out] offset position où commencer (0 pour tout le journal), puis fin du dernier enregistrement valide : la lecture suivante peut reprendre là.
+     * \return false si le fichier ne peut pas être lu, si son en-tête est invalide ou si offset dépasse sa taille.
+     */
+    bool ReadMatchLog (const string & path, const function<void (const CMatchResult &)> & visit, unsigned & nbCorrupt, size_t & offset){
+        nbCorrupt = 0;
+        const int fd (open (path.c_str (), O_RDONLY));
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat (fd, &info) != 0 || size_t (info.st_size) < sizeof (CLogHeader)){
+            close (fd);
+            return false;
+        }
+        const size_t size (info.st_size);
+        void * map (mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+        close (fd);
+        if (map == MAP_FAILED) return false;
+        madvise (map, size, MADV_SEQUENTIAL);
+        const char * data (static_cast<const char *> (map));
+
+        CLogHeader header;
+        memcpy (&header, data, sizeof (header));
+        const bool ok (memcmp (header.magic, KLogMagic, sizeof (header.magic)) == 0 && header.version == KLogVersion
+                    && header.checksum == Checksum (data, offsetof (CLogHeader, checksum)) && offset <= size);
+        if (offset < sizeof (header)) offset = sizeof (header);
+
+        //! Un seul résultat est réutilisé pour toutes les parties : ses chaînes et son vecteur gardent leur capacité.
+        CMatchResult result;
+        //! Après un enregistrement abîmé, la lecture reprend au premier octet où commence un enregistrement valide.
+        bool resync (false);
+        for (size_t next (offset); ok && next + 2 * sizeof (uint32_t) <= size;){
+            const size_t start (next);
+            size_t length;
+            if (!DecodeMatch (data + start, size - start, result, length)){
+                if (!resync) ++nbCorrupt;
+                resync = true;
+                next = start + 1;
+                continue;
+            }
+            resync = false;
+            next = offset = start + length;
+            visit (result);
+        }
+        munmap (map, size);
+        return ok;
+    } // ReadMatchLog ()
+
+    //! Index persistant des classements Elo, tenu à jour à partir du journal des parties.
+    const char KLeaderboard [] = "Classement.bin";
+    const char     KEloMagic [8] = {'C', 'M', 'I', 'Y', 'C', 'E', 'L', 'O'};
+    const uint32_t KEloVersion   = 1;
+    //! Classement de départ et coefficient K de la formule d'Elo.
+    const double   KEloStart = 1500.0;
+    const double   KEloK     = 32.0;
+    //! Le classement par rang regroupe les joueurs par point d'Elo entier dans [0, KEloBins[.
+    const unsigned KEloBins  = 4096;
+
+    /*!
+     * \struct CEloHeader
+     * \brief En-tête de l'index : capacité de la table de hachage, nombre de joueurs et position du journal déjà prise en compte.
+     */
+    struct CEloHeader {
+        char     magic [8];
+        uint32_t version;
+        uint32_t capacity;
+        uint64_t nbPlayers;
+        uint64_t logOffset;
+    };
+
+    /*!
+     * \struct CEloSlot
+     * \brief Case de la table de hachage à adressage ouvert : un joueur, reconnu par son nom (key 0 pour une case vide).
+     */
+    struct CEloSlot {
+        uint64_t key;
+        double   rating;
+        uint32_t games;
+        uint32_t wins;
+        uint32_t draws;
+        uint8_t  nameLength;
+        char     name [35];
+    };
+    static_assert (sizeof (CEloHeader) == 32 && sizeof (CEloSlot) == 64, "format du classement");
+
+    /*!
+     * \struct CLeaderboard
+     * \brief Index projeté en mémoire : en-tête, table des joueurs, puis arbre de Fenwick du nombre de joueurs par point d'Elo.
+     */
+    struct CLeaderboard {
+        int          fd;
+        size_t       size;
+        char *       map;
+        CEloHeader * header;
+        CEloSlot *   slots;
+        uint32_t *   fenwick;
+    };
+
+    /*!
+     * \fn uint64_t NameKey (const string & name)
+     * \brief Clé de hachage d'un nom (FNV-1a sur 64 bits), jamais nulle.
+     */
+    uint64_t NameKey (const string & name){
+        uint64_t hash (14695981039346656037ULL);
+        for (const char & c : name)
+            hash = (hash ^ (unsigned char) c) * 1099511628211ULL;
+        return hash ? hash : 1;
+    } // NameKey ()
+
+    /*!
+     * \fn unsigned EloBin (const double & rating)
+     * \brief Case de l'arbre de Fenwick d'un classement.
+     */
+    unsigned EloBin (const double & rating){
+        return unsigned (max (0.0, min (rating, double (KEloBins - 1))));
+    } // EloBin ()
+
+    /*!
+     * \fn void FenwickAdd (CLeaderboard & board, const unsigned & bin, const int & delta)
+     * \brief Ajoute delta au nombre de joueurs de la case bin.
+     */
+    void FenwickAdd (CLeaderboard & board, const unsigned & bin, const int & delta){
+        for (unsigned i (bin + 1); i <= KEloBins; i += i & -i)
+            board.fenwick [i - 1] += delta;
+    } // FenwickAdd ()
+
+    /*!
+     * \fn uint64_t FenwickPrefix (const CLeaderboard & board, const unsigned & bin)
+     * \brief Nombre de joueurs dans les cases [0, bin].
+     */
+    uint64_t FenwickPrefix (const CLeaderboard & board, const unsigned & bin){
+        uint64_t sum (0);
+        for (unsigned i (bin + 1); i > 0; i -= i & -i)
+            sum += board.fenwick [i - 1];
+        return sum;
+    } // FenwickPrefix ()
+
+    /*!
+     * \fn size_t LeaderboardSize (const uint32_t & capacity)
+     * \brief Taille du fichier d'index pour une table de capacity cases.
+     */
+    size_t LeaderboardSize (const uint32_t & capacity){
+        return sizeof (CEloHeader) + size_t (capacity) * sizeof (CEloSlot) + KEloBins * sizeof (uint32_t);
+    } // LeaderboardSize ()
+
+    /*!
+     * \fn bool MapLeaderboard (CLeaderboard & board, const uint32_t & capacity)
+     * \brief Donne au fichier la taille d'une table de capacity cases et le projette en mémoire partagée.
+     */
+    bool MapLeaderboard (CLeaderboard & board, const uint32_t & capacity){
+        board.size = LeaderboardSize (capacity);
+        if (ftruncate (board.fd, board.size) != 0) return false;
+        void * map (mmap (nullptr, board.size, PROT_READ | PROT_WRITE, MAP_SHARED, board.fd, 0));
+        if (map == MAP_FAILED) return false;
+        board.map     = static_cast<char *> (map);
+        board.header  = reinterpret_cast<CEloHeader *> (board.map);
+        board.slots   = reinterpret_cast<CEloSlot *> (board.map + sizeof (CEloHeader));
+        board.fenwick = reinterpret_cast<uint32_t *> (board.map + sizeof (CEloHeader) + size_t (capacity) * sizeof (CEloSlot));
+        return true;
+    } // MapLeaderboard ()
+
+    /*!
+     * \fn void ClearLeaderboard (CLeaderboard & board, const uint32_t & capacity)
+     * \brief Vide l'index projeté : aucun joueur, journal à relire depuis le début.
+     */
+    void ClearLeaderboard (CLeaderboard & board, const uint32_t & capacity){
+        memset (board.map, 0, board.size);
+        memcpy (board.header->magic, KEloMagic, sizeof (KEloMagic));
+        board.header->version  = KEloVersion;
+        board.header->capacity = capacity;
+    } // ClearLeaderboard ()
+
+    /*!
+     * \fn bool OpenLeaderboard (CLeaderboard & board, const string & path)
+     * \brief Ouvre (ou crée) l'index et le verrouille jusqu'à CloseLeaderboard (). Un index d'un autre format est reconstruit.
+     */
+    bool OpenLeaderboard (CLeaderboard & board, const string & path){
+        board.map = nullptr;
+        board.fd  = open (path.c_str (), O_RDWR | O_CREAT, 0644);
+        if (board.fd < 0) return false;
+        flock (board.fd, LOCK_EX);
+
+        CEloHeader header;
+        const bool valid (pread (board.fd, &header, sizeof (header), 0) == ssize_t (sizeof (header)) && memcmp (header.magic, KEloMagic, sizeof (KEloMagic)) == 0
+                       && header.version == KEloVersion && header.capacity >= 64 && (header.capacity & (header.capacity - 1)) == 0);
+        const uint32_t capacity (valid ? header.capacity : 1024);
+        if (!MapLeaderboard (board, capacity)){
+            close (board.fd);
+            return false;
+        }
+        if (!valid) ClearLeaderboard (board, capacity);
+        return true;
+    } // OpenLeaderboard ()
+
+    /*!
+     * \fn void CloseLeaderboard (CLeaderboard & board)
+     * \brief Écrit l'index sur disque, le libère et lève le verrou.
+     */
+    void CloseLeaderboard (CLeaderboard & board){
+        if (board.map){
+            msync (board.map, board.size, MS_SYNC);
+            munmap (board.map, board.size);
+        }
+        close (board.fd);
+    } // CloseLeaderboard ()
+
+    /*!
+     * \fn CEloSlot * FindSlot (CLeaderboard & board, const string & name, const uint64_t & key)
+     * \brief Case du joueur, ou case vide où l'insérer (sondage linéaire).
+     */
+    CEloSlot * FindSlot (CLeaderboard & board, const string & name, const uint64_t & key){
+        const uint32_t mask (board.header->capacity - 1);
+        const size_t   length (min<size_t> (name.size (), sizeof (board.slots [0].name)));
+        for (uint32_t i (key & mask);; i = (i + 1) & mask){
+            CEloSlot & slot (board.slots [i]);
+            if (slot.key == 0) return &slot;
+            if (slot.key == key && slot.nameLength == length && memcmp (slot.name, name.data (), length) == 0) return &slot;
+        }
+    } // FindSlot ()
+
+    /*!
+     * \fn bool GrowLeaderboard (CLeaderboard & board)
+     * \brief Double la capacité de la table et y réinsère les joueurs. L'arbre de Fenwick ne change pas.
+     */
+    bool GrowLeaderboard (CLeaderboard & board){
+        const uint32_t   capacity (board.header->capacity);
+        const CEloHeader header (*board.header);
+        vector<CEloSlot> VSlot (board.slots, board.slots + capacity);
+        vector<uint32_t> VFenwick (board.fenwick, board.fenwick + KEloBins);
+
+        munmap (board.map, board.size);
+        board.map = nullptr;
+        if (!MapLeaderboard (board, 2 * capacity)) return false;
+        ClearLeaderboard (board, 2 * capacity);
+        board.header->nbPlayers = header.nbPlayers;
+        board.header->logOffset = header.logOffset;
+        memcpy (board.fenwick, VFenwick.data (), KEloBins * sizeof (uint32_t));
+
+        for (const CEloSlot & slot : VSlot){
+            if (slot.key == 0) continue;
+            const uint32_t mask (2 * capacity - 1);
+            uint32_t i (slot.key & mask);
+            while (board.slots [i].key != 0)
+                i = (i + 1) & mask;
+            board.slots [i] = slot;
+        }
+        return true;
+    } // GrowLeaderboard ()
+
+    /*!
+     * \fn CEloSlot * PlayerSlot (CLeaderboard & board, const string & name)
+     * \brief Case du joueur, créée avec le classement de départ s'il n'a encore jamais joué. nullptr si l'index n'a pas pu grandir.
+     */
+    CEloSlot * PlayerSlot (CLeaderboard & board, const string & name){
+        const uint64_t key (NameKey (name));
+        CEloSlot * slot (FindSlot (board, name, key));
+        if (slot->key != 0) return slot;
+
+        //! La table est gardée à moitié vide pour que les sondages restent courts.
+        if (2 * (board.header->nbPlayers + 1) > board.header->capacity){
+            if (!GrowLeaderboard (board)) return nullptr;
+            slot = FindSlot (board, name, key);
+        }
+        slot->key        = key;
+        slot->rating     = KEloStart;
+        slot->nameLength = min<size_t> (name.size (), sizeof (slot->name));
+        memcpy (slot->name, name.data (), slot->nameLength);
+        ++board.header->nbPlayers;
+        FenwickAdd (board, EloBin (slot->rating), 1);
+        return slot;
+    } // PlayerSlot ()
+
+    /*!
+     * \fn bool RecordElo (CLeaderboard & board, const CMatchResult & result)
+     * \brief Met à jour les classements des deux joueurs d'une partie et leur place dans l'arbre de Fenwick.
+     */
+    bool RecordElo (CLeaderboard & board, const CMatchResult & result){
+        if (!PlayerSlot (board, result.names [0])) return false;
+        //! La seconde insertion peut déplacer la table : les deux cases sont cherchées après.
+        CEloSlot * player2 (PlayerSlot (board, result.names [1]));
+        if (!player2) return false;
+        CEloSlot * player1 (FindSlot (board, result.names [0], NameKey (result.names [0])));
+        if (player1 == player2) return true;
+
+        const double expected1 (1.0 / (1.0 + pow (10.0, (player2->rating - player1->rating) / 400.0)));
+        const double actual1   ((result.winner == 1) ? 1.0 : (result.winner == 2) ? 0.0 : 0.5);
+        const double delta     (KEloK * (actual1 - expected1));
+
+        CEloSlot * VPlayer [2] = {player1, player2};
+        for (unsigned side(0); side < 2; ++side){
+            CEloSlot & slot (*VPlayer [side]);
+            FenwickAdd (board, EloBin (slot.rating), -1);
+            slot.rating += (side == 0) ? delta : -delta;
+            FenwickAdd (board, EloBin (slot.rating), 1);
+            ++slot.games;
+            if (result.winner == side + 1) ++slot.wins;
+            else if (result.winner == 0)   ++slot.draws;
+        }
+        return true;
+    } // RecordElo ()
+
+    /*!
+     * \fn bool SyncLeaderboard (CLeaderboard & board, const string & logPath)
+     * \brief Prend en compte les parties ajoutées au journal depuis la dernière mise à jour, sans relire les précédentes.
+     * Si le journal a raccourci (remplacé ou effacé), l'index est reconstruit depuis le début.
+     */
+    bool SyncLeaderboard (CLeaderboard & board, const string & logPath){
+        struct stat info;
+        if (stat (logPath.c_str (), &info) != 0) return true;
+        if (board.header->logOffset > uint64_t (info.st_size))
+            ClearLeaderboard (board, board.header->capacity);
+
+        unsigned nbCorrupt;
+        size_t   offset (board.header->logOffset);
+        bool     ok (true);
+        if (!ReadMatchLog (logPath, [&] (const CMatchResult & result){ ok = RecordElo (board, result) && ok; }, nbCorrupt, offset))
+            return false;
+        board.header->logOffset = offset;
+        return ok;
+    } // SyncLeaderboard ()
+
+    /*!
+     * \fn uint64_t PlayerRank (const CLeaderboard & board, const CEloSlot & slot)
+     * \brief Rang du joueur (1 pour le meilleur) : nombre de joueurs dans une case d'Elo supérieure, plus un. Ne dépend que du nombre de cases.
+     */
+    uint64_t PlayerRank (const CLeaderboard & board, const CEloSlot & slot){
+        return board.header->nbPlayers - FenwickPrefix (board, EloBin (slot.rating)) + 1;
+    } // PlayerRank ()
+
+    /*!
+     * \fn void SaveNames (const vector<CMatchResult> & VResult)
+     * \brief Effectue la sauvegarde des résultats de toutes les parties : une ligne par partie dans Resultats.txt, un enregistrement par partie dans le journal binaire.
+     */
+    void SaveNames (const vector<CMatchResult> & VResult){
+        ofstream ofs ("Resultats.txt", ios_base::app);
+        ofs << "Liste des gagnants :" << endl;
+
+        //! Chaque partie a son résultat, match nul compris : plus besoin de retrouver le couple à partir de l'indice du gagnant.
+        for (const CMatchResult & result : VResult){
+            ofs << result.names [0] << " vs. " << result.names [1] << " : ";
+            if (result.winner == 0){
+                ofs << "match nul (" << result.VScore [0] << " / " << result.VScore [1] << ")" << endl;
+                continue;
+            }
+            unsigned score (result.VScore [result.winner - 1]);
+            ofs << result.names [result.winner - 1] << " a gagné avec " << score << ((score == 1) ? (" point") : (" points"))
+                << ((result.outcome == KOutcomeCapture) ? (" (capture)") : (result.outcome == KOutcomeRedSquare) ? (" (carré rouge)")
+                   : (result.outcome == KOutcomeTime) ? (" (temps écoulé)") : ("")) << endl;
+        }
+        ofs << endl;
+        if (!AppendMatchLog (KMatchLog, VResult))
+            cerr << "Impossible de compléter " << KMatchLog << "." << endl;
+
+        //! Le classement ne relit que les parties qui viennent d'être ajoutées.
+        CLeaderboard board;
+        if (!OpenLeaderboard (board, KLeaderboard))
+            cerr << "Impossible d'ouvrir " << KLeaderboard << "." << endl;
+        else {
+            if (!SyncLeaderboard (board, KMatchLog))
+                cerr << "Impossible de mettre à jour " << KLeaderboard << "." << endl;
+            CloseLeaderboard (board);
+        }
+        cout << endl << "Résultats sauvegardés." << endl;
+    } // SaveNames ()
+
+    /*!
+     * \fn unsigned RandomBelow (CRng & rng, const unsigned & bound)
+     * \brief Tirage uniforme dans [0, bound[, sans le biais de rng () % bound (méthode multiplicative de Lemire).
+     */
+    unsigned RandomBelow (CRng & rng, const unsigned & bound){
+        uint64_t product (uint64_t (uint32_t (rng () >> 32)) * bound);
+        uint32_t low (product);
+        if (low < bound){
+            //! Les premières valeurs de chaque tranche en trop sont rejetées.
+            const uint32_t threshold ((0u - bound) % bound);
+            while (low < threshold){
+                product = uint64_t (uint32_t (rng () >> 32)) * bound;
+                low     = product;
+            }
+        }
+        return product >> 32;
+    } // RandomBelow ()
+
+    /*!
+     * \fn uint64_t MatchSeed (const uint64_t & baseSeed, const uint64_t & match)
+     * \brief Graine de la partie numéro match d'une série lancée avec baseSeed. Elle ne dépend pas de l'ordre dans lequel les parties sont jouées.
+     */
+    uint64_t MatchSeed (const uint64_t & baseSeed, const uint64_t & match){
+        CRng rng;
+        rng.Seed (baseSeed ^ (match * 0xD1B54A32D192ED03ULL));
+        return rng ();
+    } // MatchSeed ()
+
+    /*!
+     * \fn size_t GeneratePosition (CRng & rng, const CFreeCells & freeCells)
+     * \brief Tire une case vide pour un pion spécial, en un seul tirage. Renvoie KNoCell si la grille est pleine.
+     */
+    size_t GeneratePosition (CRng & rng, const CFreeCells & freeCells){
+        if (freeCells.count == 0) return KNoCell;
+        return freeCells.CellAt (RandomBelow (rng, freeCells.count));
+    } // GeneratePosition ()
+
+    /*!
+     * \brief Fait apparaitre le carré rouge aléatoirement.
+     */
+    void MakeRedSquareAppear (CRng           & rng,
+                              CMatrix        & mat,
+                              const char     & KTokenRedSquare,
+                              bool           & doesRedSquare,
+                              CPosition      & posRedSquare,
+                              const unsigned & chance,
+                              CFreeCells     & freeCells){
+        unsigned random = RandomBelow (rng, 100);
+        if (random < chance){
+            const size_t cell (GeneratePosition (rng, freeCells));
+            if (cell == KNoCell) return;
+
+			//! Empêchera la génération d'autres carrés rouges.
+            doesRedSquare = false; 
+            posRedSquare = CellPosition (cell, mat.side);
+
+            //! Le token est introduit dans la matrice.
+            mat[posRedSquare] = KTokenRedSquare;
+            freeCells.Remove (cell);
+        }
+    } // MakeRedSquareAppear ()
+
+    /*!
+     * \brief Fait apparaitre des pièces aléatoirement.
+     */
+    void MakeCoinAppear (CRng           & rng,
+                         CMatrix        & mat,
+                         CCoinStore     & VPosCoin,
+                         CBitPlane      & coinPlane,
+                         const unsigned & chance,
+                         CFreeCells     & freeCells){
+        unsigned random = RandomBelow (rng, 100);
+        if (random < chance){
+            const size_t cell (GeneratePosition (rng, freeCells));
+            if (cell == KNoCell) return;
+
+            //! La pièce est posée sur la grille et enregistrée dans VPosCoin pour être ramassée plus tard.
+            AddCoin (VPosCoin, coinPlane, mat, cell);
+            freeCells.Remove (cell);
+        }
+    } // MakeCoinAppear ()
+
+    /*!
+     * \fn void SpawnTokens (CGameState & game)
+     * \brief Fait apparaitre aléatoirement les pions spéciaux avant le coup du joueur dont c'est le tour.
+     */
+    void SpawnTokens (CGameState & game){
+        const uint64_t start (ProbeStart (game.telemetry));
+        if (game.freeCells.count == 0) AddCounter (game.telemetry, KCounterSpawnFull, 1);
+        if (game.doesRedSquare){
+            MakeRedSquareAppear (game.rng, game.mat, KTokenRedSquare, game.doesRedSquare, game.posRedSquare, game.chance, game.freeCells);
+            if (!game.doesRedSquare)
+                game.planes [KPlaneRedSquare].Set (game.mat.Index (game.posRedSquare.first, game.posRedSquare.second));
+        }
+        MakeCoinAppear (game.rng, game.mat, game.VPosCoin, game.planes [KPlaneCoin], game.chance, game.freeCells);
+        ProbeStop (game.telemetry, KProbeSpawn, start);
+    } // SpawnTokens ()
+
+    /*!
+     * \fn void InitGame (CGameState & game, const unsigned & matrixSize, const uint64_t & seed)
+     * \brief Prépare une nouvelle partie : grille vide, joueurs dans les coins, pions spéciaux du premier coup.
+     * \param seed graine de la partie, qui détermine toutes les apparitions.
+     */
+    void InitGame (CGameState & game, const unsigned & matrixSize, const uint64_t & seed){
+        game.matrixSize = matrixSize;
+        game.seed       = seed;
+        game.rng.Seed (seed);
+        game.VMove.clear ();
+        InitMat (game.mat, matrixSize);
+
+        game.posPlayer1 = make_pair (0, matrixSize - 1);
+        game.posPlayer2 = make_pair (matrixSize - 1, 0);
+        game.mat[game.posPlayer1] = TokenPlayer1;
+        game.mat[game.posPlayer2] = TokenPlayer2;
+
+        for (CBitPlane & plane : game.planes)
+            plane.Reset (game.mat.cells.size ());
+        game.planes [KPlanePlayer1].Set (game.mat.Index (game.posPlayer1.first, game.posPlayer1.second));
+        game.planes [KPlanePlayer2].Set (game.mat.Index (game.posPlayer2.first, game.posPlayer2.second));
+        game.freeCells.Reset (game.mat.cells.size ());
+        game.freeCells.Remove (game.mat.Index (game.posPlayer1.first, game.posPlayer1.second));
+        game.freeCells.Remove (game.mat.Index (game.posPlayer2.first, game.posPlayer2.second));
+
+        game.posRedSquare  = CPosition ();
+        game.doesRedSquare = true;
+        game.VPosCoin.cells.clear ();
+        game.VPosCoin.slot.clear ();
+        game.VPosCoin.VBlock.clear ();
+        game.VScore [0] = game.VScore [1] = 0;
+
+        //! Le nombre de tours est proportionnel à la taille de la matrice. Sinon si le plateau est top grand les joueurs ne pourraient pas s'atteindre.
+        game.compteTour = matrixSize * 1.5;
+        game.turn   = 1;
+        game.winner = 0;
+        game.timeForfeit = false;
+        game.decided     = false;
+        game.cptJ1  = game.cptJ2 = 0;
+        game.chance = 30;
+
+        SpawnTokens (game);
+    } // InitGame ()
+
+    /*!
+     * \fn bool IsOver (const CGameState & game)
+     * \brief Indique si la partie est terminée (victoire, plus de tours, ou résultat acquis avec earlyEnd).
+     */
+    bool IsOver (const CGameState & game){
+        return game.winner != 0 || game.compteTour == 0 || game.decided;
+    } // IsOver ()
+
+    /*!
+     * \fn unsigned Chebyshev (const CPosition & a, const CPosition & b)
+     * \brief Nombre de déplacements (en diagonale compris) pour aller de a à b sur une grille vide.
+     */
+    unsigned Chebyshev (const CPosition & a, const CPosition & b){
+        const unsigned dx (a.first  > b.first  ? a.first  - b.first  : b.first  - a.first);
+        const unsigned dy (a.second > b.second ? a.second - b.second : b.second - a.second);
+        return max (dx, dy);
+    } // Chebyshev ()
+
+    /*!
+     * \fn unsigned MovesLeft (const unsigned & compteTour, const unsigned & turn, const unsigned & player)
+     * \brief Déplacements qui restent au joueur player (1 ou 2) quand c'est à turn de jouer : le joueur 2 joue en dernier dans un tour.
+     */
+    unsigned MovesLeft (const unsigned & compteTour, const unsigned & turn, const unsigned & player){
+        return compteTour - ((turn == 2 && player == 1) ? 1 : 0);
+    } // MovesLeft ()
+
+    /*!
+     * \fn bool ResultDecided (const CPosition & pos1, const CPosition & pos2, const int & lead, const unsigned & compteTour, const unsigned & turn, const CPosition * posRed, const bool & redPending)
+     * \brief Indique si le résultat ne peut plus changer d'ici la fin des tours, quoi que jouent les joueurs et quoi qu'il apparaisse :
+     * capture hors d'atteinte, carré rouge hors d'atteinte de chacun et avance aux points impossible à rattraper.
+     * Une pièce ne rapporte qu'un point et un déplacement ne rapproche que d'une case (distance de Chebyshev) : les bornes sont exactes sur une grille vide.
+     * \param lead points du joueur 1 moins ceux du joueur 2.
+     * \param posRed position du carré rouge, nullptr s'il n'est pas sur la grille.
+     * \param redPending le carré rouge peut encore apparaitre, n'importe où : il reste alors à portée.
+     */
+    bool ResultDecided (const CPosition & pos1, const CPosition & pos2, const int & lead, const unsigned & compteTour, const unsigned & turn, const CPosition * posRed, const bool & redPending){
+        const unsigned moves1 (MovesLeft (compteTour, turn, 1));
+        const unsigned moves2 (MovesLeft (compteTour, turn, 2));
+        if (moves1 + moves2 == 0) return true;
+        if (redPending) return false;
+        //! Chaque déplacement, de l'un ou de l'autre, réduit la distance d'au plus 1 ; le dernier doit arriver sur l'adversaire.
+        if (Chebyshev (pos1, pos2) <= moves1 + moves2) return false;
+        if (posRed && (Chebyshev (pos1, *posRed) <= moves1 || Chebyshev (pos2, *posRed) <= moves2)) return false;
+        //! Celui qui est mené ramasse au plus une pièce par déplacement : il ne peut même pas égaliser s'il a plus de retard que de déplacements.
+        if (lead > 0) return unsigned (lead)  > moves2;
+        if (lead < 0) return unsigned (-lead) > moves1;
+        return false;
+    } // ResultDecided ()
+
+    /*!
+     * \fn bool IsDecided (const CGameState & game)
+     * \brief Indique si le résultat de la partie ne peut plus changer (ResultDecided ()).
+     */
+    bool IsDecided (const CGameState & game){
+        return ResultDecided (game.posPlayer1, game.posPlayer2, int (game.VScore [0]) - int (game.VScore [1]), game.compteTour, game.turn,
+                              game.doesRedSquare ? nullptr : &game.posRedSquare, game.doesRedSquare);
+    } // IsDecided ()
+
+    /*!
+     * \fn void Forfeit (CGameState & game)
+     * \brief Le joueur dont c'est le tour n'a plus de temps : il perd la partie.
+     */
+    void Forfeit (CGameState & game){
+        if (IsOver (game)) return;
+        game.winner      = 3 - game.turn;
+        game.timeForfeit = true;
+    } // Forfeit ()
+
+    /*!
+     * \fn CMatchResult MatchResult (const CGameState & game, const string & name1, const string & name2)
+     * \brief Résultat d'une partie terminée : le vainqueur aux points est désigné quand personne n'a gagné par capture ou carré rouge.
+     */
+    CMatchResult MatchResult (const CGameState & game, const string & name1, const string & name2){
+        CMatchResult result;
+        result.names [0]  = name1;
+        result.names [1]  = name2;
+        result.seed       = game.seed;
+        result.matrixSize = game.matrixSize;
+        result.VScore [0] = game.VScore [0];
+        result.VScore [1] = game.VScore [1];
+        result.VMove      = game.VMove;
+        if (game.winner != 0){
+            result.winner  = game.winner;
+            result.outcome = game.timeForfeit ? KOutcomeTime : (game.posPlayer1 == game.posPlayer2) ? KOutcomeCapture : KOutcomeRedSquare;
+        }
+        else {
+            result.winner  = (game.VScore [0] > game.VScore [1]) ? 1 : (game.VScore [0] < game.VScore [1]) ? 2 : 0;
+            result.outcome = KOutcomePoints;
+        }
+        return result;
+    } // MatchResult ()
+
+    /*!
+     * \fn TStepStatus Step (CGameState & game, const char & move)
+     * \brief Joue le coup du joueur dont c'est le tour et applique les règles. Si le coup est refusé, l'état n'est pas modifié.
+     * Quand la partie continue, les pions spéciaux du coup suivant sont déjà apparus au retour de la fonction.
+     */
+    TStepStatus Step (CGameState & game, const char & move){
+        if (IsOver (game)) return KStepGameOver;
+        const uint64_t start (ProbeStart (game.telemetry));
+
+        const bool isPlayer1 (game.turn == 1);
+        CPosition & pos (isPlayer1 ? game.posPlayer1 : game.posPlayer2);
+
+        TStepStatus status = CheckMove (move, pos, game.matrixSize);
+        if (status != KStepOk){
+            ProbeStop (game.telemetry, KProbeValidation, start);
+            return status;
+        }
+
+        //! Le pion se déplace. C'est le pion 1 qui bouge si on est au tour 1 et inversement.
+        CBitPlane & plane (game.planes [isPlayer1 ? KPlanePlayer1 : KPlanePlayer2]);
+        const size_t from (game.mat.Index (pos.first, pos.second));
+        plane.Clear (from);
+        game.freeCells.Insert (from);
+        ApplyMove (game.mat, move, pos, isPlayer1 ? TokenPlayer1 : TokenPlayer2);
+        const size_t cell (game.mat.Index (pos.first, pos.second));
+        plane.Set (cell);
+        game.freeCells.Remove (cell);
+        game.VMove.push_back (KMoveKeys [KMoveTable.entry [(unsigned char) move].dir]);
+        ++(isPlayer1 ? game.cptJ1 : game.cptJ2);
+
+        //! Si un des joueurs se trouve sur l'autre, ou sur le carré rouge une fois apparu, il gagne.
+        if (game.posPlayer1 == game.posPlayer2 || game.planes [KPlaneRedSquare].Test (cell)){
+            game.winner = game.turn;
+            ProbeStop (game.telemetry, KProbeValidation, start);
+            return KStepOk;
+        }
+        //! Si un des joueurs se trouve sur une pièce, il la ramasse et gagne un point.
+        if (game.planes [KPlaneCoin].Test (cell) && RemoveCoin (game.VPosCoin, game.planes [KPlaneCoin], game.mat, cell))
+            ++game.VScore [game.turn - 1];
+
+        //! Le tour est décompté quand les deux joueurs ont joué.
+        if (isPlayer1)
+            game.turn = 2;
+        else {
+            game.turn = 1;
+            --game.compteTour;
+        }
+        //! Plus rien ne peut changer le résultat : inutile de jouer les tours restants, le décompte des points suffit.
+        if (game.earlyEnd && !IsOver (game) && IsDecided (game))
+            game.decided = true;
+        ProbeStop (game.telemetry, KProbeValidation, start);
+        if (!IsOver (game))
+            SpawnTokens (game);
+        return KStepOk;
+    } // Step ()
+
+    /*!
+     * \fn bool ReplayGame (CGameState & game, const unsigned & matrixSize, const uint64_t & seed, const vector<char> & VMove)
+     * \brief Rejoue une partie à partir de sa graine et de ses coups. Renvoie false si un coup est refusé.
+     */
+    bool ReplayGame (CGameState & game, const unsigned & matrixSize, const uint64_t & seed, const vector<char> & VMove){
+        InitGame (game, matrixSize, seed);
+        for (const char & move : VMove)
+            if (Step (game, move) != KStepOk) return false;
+        return true;
+    } // ReplayGame ()
+
+    /*!
+     * \fn void MoveToken (CGameState & game, char & move, long long & clockMs)
+     * \brief Deplace le joueur dont c'est le tour. Tant que le déplacement est impossible ou la saisie incorrecte, une nouvelle valeur de move est demandée.
+     * Si la pendule du joueur tombe pendant la saisie, il perd la partie (Forfeit ()).
+     * \param[in-out] move caractère prenant une des valeurs présentes à coté de la matrice lors de l'affichage (Z,D,X,Q,A,E,C,W)
+     * \param[in-out] clockMs temps restant au joueur, -1 sans pendule
+     */
+    void MoveToken (CGameState & game, char & move, long long & clockMs){
+        for (TStepStatus status; (status = Step (game, move)) != KStepOk && status != KStepGameOver;){
+            cout << ((status == KStepOutOfBoard) ? ("Deplacement impossible.") : ("Saisie incorrecte.")) << endl;
+            AddCounter (game.telemetry, KCounterReprompts, 1);
+            if (!PromptMove (move, clockMs, game.telemetry)){
+                Forfeit (game);
+                return;
+            }
+        }
+    } // MoveToken ()
+
+    /*!
+     * \fn char BotMove (const CGameState & game, CRng & botRng)
+     * \brief Choisit le coup d'un joueur ordinateur simple : capture ou carré rouge si possible, sinon une pièce, en évitant de finir à portée de l'adversaire.
+     * \param botRng générateur propre au joueur ordinateur, pour ne pas décaler les apparitions de la partie.
+     */
+    char BotMove (const CGameState & game, CRng & botRng){
+        const CPosition & pos   (game.turn == 1 ? game.posPlayer1 : game.posPlayer2);
+        const CPosition & other (game.turn == 1 ? game.posPlayer2 : game.posPlayer1);
+
+        const unsigned legal (LegalMoves (pos, game.matrixSize));
+        char best (KMoveKeys [0]);
+        int  bestScore (INT_MIN);
+        for (unsigned k(0); k < 8; ++k){
+            if (!(legal & (1u << k))) continue;
+            CPosition dest = Destination (KMoveKeys [k], pos);
+
+            int score (RandomBelow (botRng, 8));
+            if (dest == other)
+                score += 10000;
+            else if (!game.doesRedSquare && dest == game.posRedSquare)
+                score += 9000;
+            else {
+                if (game.planes [KPlaneCoin].Test (game.mat.Index (dest.first, dest.second))) score += 50;
+                //! Une case voisine de l'adversaire lui offre la capture au coup suivant.
+                unsigned dx = max (dest.first, other.first) - min (dest.first, other.first);
+                unsigned dy = max (dest.second, other.second) - min (dest.second, other.second);
+                if (max (dx, dy) <= 1) score -= 5000;
+            }
+            if (score > bestScore){
+                bestScore = score;
+                best = KMoveKeys [k];
+            }
+        }
+        return best;
+    } // BotMove ()
+
+    //! Table de finales : résultat exact de chaque position de capture, calculé par analyse rétrograde (--build-tablebase).
+    const char     KTablebaseFile [] = "Finales.bin";
+    const char     KTableMagic [8] = {'C', 'M', 'I', 'Y', 'C', 'F', 'I', 'N'};
+    const uint32_t KTableVersion   = 1;
+    //! Plus grande grille de la table : au-delà, la table devient trop grande pour être projetée sans y penser.
+    const unsigned KTableMaxSize   = 8;
+    //! Distance au mat maximale enregistrée, en demi-coups.
+    const unsigned KTableMaxPlies  = 255;
+
+    /*!
+     * \struct CTableHeader
+     * \brief En-tête de la table (96 octets) : position de la table de chaque taille (0 si elle est absente) et somme de contrôle des tables.
+     * La table d'une taille n contient un octet par position (trait, carré rouge, joueur 1, joueur 2), voir TableIndex ().
+     */
+    struct CTableHeader {
+        char     magic [8];
+        uint32_t version;
+        uint32_t maxSize;
+        uint64_t offset [KTableMaxSize + 1];
+        uint32_t checksum;
+        uint32_t reserved;
+    };
+    static_assert (sizeof (CTableHeader) == 96, "format de la table de finales");
+
+    /*!
+     * \struct CTablebase
+     * \brief Table de finales projetée en mémoire (--tablebase), header == nullptr si aucune n'est chargée.
+     */
+    struct CTablebase {
+        const char *         map;
+        size_t               size;
+        const CTableHeader * header;
+    };
+
+    CTablebase Tablebase = {nullptr, 0, nullptr};
+
+    /*!
+     * \fn size_t TableIndex (const unsigned & matrixSize, const unsigned & side, const size_t & red, const size_t & cell1, const size_t & cell2)
+     * \brief Position d'une case de la table de taille matrixSize : side joueur qui a le trait (0 ou 1), red case du carré rouge, cell1 et cell2 cases des joueurs.
+     */
+    size_t TableIndex (const unsigned & matrixSize, const unsigned & side, const size_t & red, const size_t & cell1, const size_t & cell2){
+        const size_t nbCells (size_t (matrixSize) * matrixSize);
+        return ((side * nbCells + red) * nbCells + cell1) * nbCells + cell2;
+    } // TableIndex ()
+
+    /*!
+     * \fn void SolveTable (const unsigned & matrixSize, vector<uint8_t> & VValue)
+     * \brief Résout par analyse rétrograde toutes les positions d'une grille matrixSize avec le carré rouge posé et sans limite de tours.
+     * VValue [TableIndex ()] vaut d impair si le joueur qui a le trait gagne (capture ou carré rouge) en d demi-coups au plus,
+     * d pair s'il perd en d demi-coups au mieux, 0 si aucun ne peut forcer la victoire (ou si la position est impossible).
+     * Les positions gagnées en d + 1 demi-coups sont déduites de celles résolues en d, en remontant les coups ; une position n'est perdue
+     * que quand tous ses coups ont mené à une position gagnée par l'adversaire, ce que compte VLeft.
+     */
+    void SolveTable (const unsigned & matrixSize, vector<uint8_t> & VValue){
+        const size_t nbCells (size_t (matrixSize) * matrixSize);
+        VValue.assign (2 * nbCells * nbCells * nbCells, 0);
+        vector<uint8_t>  VLeft (VValue.size (), 0);
+        vector<uint32_t> VCurrent, VNext;
+
+        //! Un coup sur l'adversaire ou sur le carré rouge gagne tout de suite ; les autres coups restent à réfuter.
+        for (unsigned side(0); side < 2; ++side)
+            for (size_t red(0); red < nbCells; ++red)
+                for (size_t cell1(0); cell1 < nbCells; ++cell1)
+                    for (size_t cell2(0); cell2 < nbCells; ++cell2){
+                        if (cell1 == cell2 || red == cell1 || red == cell2) continue;
+                        const size_t    index (TableIndex (matrixSize, side, red, cell1, cell2));
+                        const size_t    other (side ? cell1 : cell2);
+                        const CPosition pos (CellPosition (side ? cell2 : cell1, matrixSize));
+                        const unsigned  legal (LegalMoves (pos, matrixSize));
+                        for (unsigned k(0); k < 8; ++k){
+                            if (!(legal & (1u << k))) continue;
+                            const CPosition dest (Destination (KMoveKeys [k], pos));
+                            const size_t    cell (size_t (dest.first) * matrixSize + dest.second);
+                            if (cell == other || cell == red)
+                                VValue [index] = 1;
+                            else
+                                ++VLeft [index];
+                        }
+                        if (VValue [index]) VCurrent.push_back (index);
+                    }
+
+        for (unsigned plies(1); !VCurrent.empty () && plies < KTableMaxPlies; ++plies){
+            VNext.clear ();
+            for (const uint32_t & index : VCurrent){
+                const size_t   cell2 (index % nbCells);
+                const size_t   cell1 (index / nbCells % nbCells);
+                const size_t   red   (index / nbCells / nbCells % nbCells);
+                const unsigned side  (index / nbCells / nbCells / nbCells);
+                //! Le joueur qui vient de jouer (1 - side) arrivait d'une case voisine, libre et différente du carré rouge.
+                const CPosition pos (CellPosition (side ? cell1 : cell2, matrixSize));
+                const size_t    other (side ? cell2 : cell1);
+                const unsigned  legal (LegalMoves (pos, matrixSize));
+                for (unsigned k(0); k < 8; ++k){
+                    if (!(legal & (1u << k))) continue;
+                    const CPosition from (Destination (KMoveKeys [k], pos));
+                    const size_t    cell (size_t (from.first) * matrixSize + from.second);
+                    if (cell == other || cell == red) continue;
+                    const size_t previous (side ? TableIndex (matrixSize, 0, red, cell, cell2) : TableIndex (matrixSize, 1, red, cell1, cell));
+                    if (VValue [previous]) continue;
+                    //! Mener l'adversaire dans une position perdue gagne ; une position gagnée par l'adversaire réfute un coup.
+                    if (plies % 2 == 0 || --VLeft [previous] == 0){
+                        VValue [previous] = plies + 1;
+                        VNext.push_back (previous);
+                    }
+                }
+            }
+            VCurrent.swap (VNext);
+        }
+    } // SolveTable ()
+
+    /*!
+     * \fn bool OpenTablebase (const string & path)
+     * \brief Projette en mémoire la table de finales path et vérifie sa signature et sa somme de contrôle.
+     */
+    bool OpenTablebase (const string & path){
+        const int fd (open (path.c_str (), O_RDONLY));
+        if (fd < 0) return false;
+        struct stat info;
+        void * map (fstat (fd, &info) == 0 && size_t (info.st_size) >= sizeof (CTableHeader) ? mmap (nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED);
+        close (fd);
+        if (map == MAP_FAILED) return false;
+
+        const char *         data (static_cast<const char *> (map));
+        const CTableHeader * header (reinterpret_cast<const CTableHeader *> (data));
+        bool valid (memcmp (header->magic, KTableMagic, sizeof (KTableMagic)) == 0 && header->version == KTableVersion && header->maxSize <= KTableMaxSize
+                 && header->checksum == Checksum (data + sizeof (CTableHeader), info.st_size - sizeof (CTableHeader)));
+        for (unsigned size(2); valid && size <= header->maxSize; ++size)
+            valid = header->offset [size] == 0 || header->offset [size] + 2 * uint64_t (size * size) * (size * size) * (size * size) <= uint64_t (info.st_size);
+        if (!valid){
+            munmap (map, info.st_size);
+            return false;
+        }
+        Tablebase.map    = data;
+        Tablebase.size   = info.st_size;
+        Tablebase.header = header;
+        return true;
+    } // OpenTablebase ()
+
+    /*!
+     * \fn unsigned TableValue (const unsigned & matrixSize, const unsigned & side, const size_t & red, const size_t & cell1, const size_t & cell2)
+     * \brief Valeur de SolveTable () d'une position, lue dans la table projetée.
+     */
+    unsigned TableValue (const unsigned & matrixSize, const unsigned & side, const size_t & red, const size_t & cell1, const size_t & cell2){
+        return (unsigned char) Tablebase.map [Tablebase.header->offset [matrixSize] + TableIndex (matrixSize, side, red, cell1, cell2)];
+    } // TableValue ()
+
+    /*!
+     * \fn int TablebaseProbe (const CGameState & game, char & move)
+     * \brief Cherche la position de la partie dans la table de finales. Renvoie d > 0 si le joueur qui a le trait gagne en d demi-coups au plus
+     * et move le coup qui gagne le plus vite, -d s'il perd en d demi-coups quoi qu'il joue et move le coup qui retarde le plus la défaite,
+     * 0 si aucune victoire ne peut être forcée avant la fin des tours ou si la position n'est pas dans la table.
+     * Seules les positions où le carré rouge est posé sont dans la table : tant qu'il peut apparaitre n'importe où, rien n'est certain.
+     * Les pièces ne changent que les points : elles ne comptent pas ici.
+     */
+    int TablebaseProbe (const CGameState & game, char & move){
+        const unsigned size (game.matrixSize);
+        if (!Tablebase.header || size > Tablebase.header->maxSize || Tablebase.header->offset [size] == 0 || game.doesRedSquare || IsOver (game)) return 0;
+
+        const unsigned side (game.turn - 1);
+        const size_t   red (game.mat.Index (game.posRedSquare.first, game.posRedSquare.second));
+        const size_t   cell1 (game.mat.Index (game.posPlayer1.first, game.posPlayer1.second));
+        const size_t   cell2 (game.mat.Index (game.posPlayer2.first, game.posPlayer2.second));
+        //! La table ignore la limite de tours : une victoire en d demi-coups n'est acquise que s'il en reste au moins d.
+        const unsigned value (TableValue (size, side, red, cell1, cell2));
+        const unsigned pliesLeft (MovesLeft (game.compteTour, game.turn, 1) + MovesLeft (game.compteTour, game.turn, 2));
+        if (value == 0 || value > pliesLeft) return 0;
+
+        //! Chaque coup mène à une position de l'adversaire : la victoire passe par une position perdue pour lui en value - 1, la défaite par la plus lointaine.
+        const CPosition & pos (side ? game.posPlayer2 : game.posPlayer1);
+        const unsigned legal (LegalMoves (pos, size));
+        unsigned best (0);
+        for (unsigned k(0); k < 8; ++k){
+            if (!(legal & (1u << k))) continue;
+            const CPosition dest (Destination (KMoveKeys [k], pos));
+            const size_t    cell (game.mat.Index (dest.first, dest.second));
+            if (cell == red || cell == (side ? cell1 : cell2)){
+                if (value == 1) move = KMoveKeys [k];
+                continue;
+            }
+            const unsigned next (side ? TableValue (size, 0, red, cell1, cell) : TableValue (size, 1, red, cell, cell2));
+            if (value % 2 == 1 ? next == value - 1 : next > best){
+                move = KMoveKeys [k];
+                best = next;
+            }
+        }
+        return value % 2 == 1 ? int (value) : -int (value);
+    } // TablebaseProbe ()
+
+    /*!
+     * \fn int TablebaseMain (int argc, char * argv [])
+     * \brief Génère la table de finales : --build-tablebase [tailleMax] [fichier]. Toutes les grilles de 2 à tailleMax (8 par défaut) sont résolues.
+     */
+    int TablebaseMain (int argc, char * argv []){
+        const unsigned maxSize (argc > 2 ? strtoul (argv [2], nullptr, 10) : KTableMaxSize);
+        const string   path (argc > 3 ? argv [3] : KTablebaseFile);
+        if (maxSize < 2 || maxSize > KTableMaxSize){
+            cerr << "Usage : " << argv [0] << " --build-tablebase [tailleMax (2 à " << KTableMaxSize << ")] [fichier]" << endl;
+            return EXIT_FAILURE;
+        }
+
+        CTableHeader header;
+        memset (&header, 0, sizeof (header));
+        memcpy (header.magic, KTableMagic, sizeof (KTableMagic));
+        header.version = KTableVersion;
+        header.maxSize = maxSize;
+        vector<char>    VData;
+        vector<uint8_t> VValue;
+        for (unsigned size(2); size <= maxSize; ++size){
+            const chrono::steady_clock::time_point start (chrono::steady_clock::now ());
+            SolveTable (size, VValue);
+            header.offset [size] = sizeof (CTableHeader) + VData.size ();
+            VData.insert (VData.end (), VValue.begin (), VValue.end ());
+
+            size_t nbWon (0), nbLost (0);
+            unsigned longest (0);
+            for (const uint8_t & value : VValue){
+                if (value == 0) continue;
+                ++(value % 2 ? nbWon : nbLost);
+                longest = max (longest, unsigned (value));
+            }
+            cout << size << "x" << size << " : " << VValue.size () << " positions, " << nbWon << " gagnées, " << nbLost << " perdues, au plus "
+                 << longest << " demi-coups (" << chrono::duration_cast<chrono::milliseconds> (chrono::steady_clock::now () - start).count () << " ms)" << endl;
+        }
+        header.checksum = Checksum (VData.data (), VData.size ());
+
+        //! Écrite à côté puis renommée : une partie qui charge la table ne voit jamais un fichier à moitié écrit.
+        const string temporary (path + ".tmp");
+        {
+            ofstream file (temporary, ios::binary | ios::trunc);
+            file.write (reinterpret_cast<const char *> (&header), sizeof (header));
+            file.write (VData.data (), VData.size ());
+            if (!file){
+                cerr << "Écriture de " << temporary << " impossible." << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        if (rename (temporary.c_str (), path.c_str ()) != 0){
+            cerr << "Écriture de " << path << " impossible : " << strerror (errno) << endl;
+            return EXIT_FAILURE;
+        }
+        cout << path << " : " << sizeof (header) + VData.size () << " octets" << endl;
+        return 0;
+    } // TablebaseMain ()
+
+    //! Score d'une partie gagnée, diminué du nombre de demi-coups pour préférer les victoires rapides.
+    const int KWin = 1000000;
+    //! Nombre maximal de demi-coups explorés par la recherche.
+    const unsigned KMaxPly = 64;
+    //! Nombre maximal de pièces prises en compte par l'évaluation.
+    const unsigned KMaxCandidateCoins = 32;
+
+    /*!
+     * \struct CTTEntry
+     * \brief Entrée de la table de transposition : position (clé de Zobrist), profondeur, score et type de borne, meilleur coup (indice dans KMoveKeys).
+     */
+    struct CTTEntry {
+        uint64_t      key;
+        int32_t       score;
+        int16_t       depth;
+        unsigned char bound;
+        unsigned char move;
+    };
+    enum TBound { KBoundExact, KBoundLower, KBoundUpper };
+
+    /*!
+     * \struct CSearchBot
+     * \brief Joueur ordinateur à recherche alpha-bêta : sa table de transposition et son budget de temps par coup.
+     */
+    struct CSearchBot {
+        vector<CTTEntry> table;
+        unsigned         budgetMs;
+    };
+
+    /*!
+     * \struct CSearchContext
+     * \brief Position explorée par la recherche. Seuls les joueurs bougent : les pièces ramassées sur le chemin sont empilées dans VTaken et
+     * les apparitions aléatoires à venir ne sont pas simulées.
+     */
+    struct CSearchContext {
+        const CGameState *                game;
+        CSearchBot *                      bot;
+        CPosition                         pos [2];
+        unsigned                          side;
+        unsigned                          compteTour;
+        int                               score [2];
+        size_t                            redCell;
+        CPosition                         posRed;
+        size_t                            VTaken [KMaxPly];
+        unsigned                          nbTaken;
+        CPosition                         VCandidate [KMaxCandidateCoins];
+        size_t                            VCandidateCell [KMaxCandidateCoins];
+        unsigned                          nbCandidates;
+        uint64_t                          hash;
+        unsigned long long                nodes;
+        chrono::steady_clock::time_point  deadline;
+        bool                              stop;
+    };
+
+    /*!
+     * \fn uint64_t ZobristKey (const unsigned & kind, const uint64_t & value)
+     * \brief Clé de Zobrist d'un élément de position (kind : 0 et 1 pion des joueurs, 2 et 3 pièce ramassée par le joueur 1 ou 2, 4 tours restants, 5 trait,
+     * 6 pièce sur la grille au début de la recherche, 7 case du carré rouge, 8 écart de points au début de la recherche).
+     * Les clés sont calculées par hachage au lieu d'être stockées, pour ne pas dépendre de la taille de la grille.
+     */
+    uint64_t ZobristKey (const unsigned & kind, const uint64_t & value){
+        uint64_t z ((value << 4 | kind) + 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    } // ZobristKey ()
+
+    /*!
+     * \fn bool IsCoinLeft (const CSearchContext & ctx, const size_t & cell)
+     * \brief Indique si une pièce est sur la case et n'a pas déjà été ramassée dans la variante explorée.
+     */
+    bool IsCoinLeft (const CSearchContext & ctx, const size_t & cell){
+        if (!ctx.game->planes [KPlaneCoin].Test (cell)) return false;
+        for (unsigned i(0); i < ctx.nbTaken; ++i)
+            if (ctx.VTaken [i] == cell) return false;
+        return true;
+    } // IsCoinLeft ()
+
+    /*!
+     * \fn int Evaluate (const CSearchContext & ctx)
+     * \brief Évaluation d'une position non terminale, du point de vue du joueur qui a le trait : points d'avance, course au carré rouge, pièces proches.
+     */
+    int Evaluate (const CSearchContext & ctx){
+        const unsigned me (ctx.side), other (1 - ctx.side);
+        //! Déplacements qui restent à chacun : le joueur 2 joue en dernier dans un tour.
+        const unsigned movesLeft [2] = {MovesLeft (ctx.compteTour, ctx.side + 1, 1), MovesLeft (ctx.compteTour, ctx.side + 1, 2)};
+
+        int value (1000 * (ctx.score [me] - ctx.score [other]));
+
+        if (ctx.redCell != KNoCell){
+            const unsigned dMe    (Chebyshev (ctx.pos [me],    ctx.posRed));
+            const unsigned dOther (Chebyshev (ctx.pos [other], ctx.posRed));
+            //! Avec le trait, on arrive le premier à égalité de distance.
+            if (dMe <= dOther && dMe <= movesLeft [me])
+                value += 5000 - 10 * dMe;
+            else if (dOther < dMe && dOther <= movesLeft [other])
+                value -= 5000 - 10 * dOther;
+        }
+        for (unsigned i(0); i < ctx.nbCandidates; ++i){
+            if (!IsCoinLeft (ctx, ctx.VCandidateCell [i])) continue;
+            const int dMe    (Chebyshev (ctx.pos [me],    ctx.VCandidate [i]));
+            const int dOther (Chebyshev (ctx.pos [other], ctx.VCandidate [i]));
+            if (dMe <= dOther) value += max (0, 40 - 4 * dMe);
+            else               value -= max (0, 40 - 4 * dOther);
+        }
+        return value;
+    } // Evaluate ()
+
+    /*!
+     * \fn int Negamax (CSearchContext & ctx, int depth, int alpha, int beta, const unsigned & ply)
+     * \brief Recherche alpha-bêta (forme negamax) avec table de transposition. Le score est du point de vue du joueur qui a le trait.
+     */
+    int Negamax (CSearchContext & ctx, const int & depth, int alpha, int beta, const unsigned & ply){
+        if ((++ctx.nodes & 1023) == 0 && chrono::steady_clock::now () > ctx.deadline)
+            ctx.stop = true;
+        if (ctx.stop) return 0;
+
+        const unsigned me (ctx.side), other (1 - ctx.side);
+        //! Une capture ou le carré rouge à un pas gagnent au coup suivant, quelle que soit la profondeur restante. À la racine, il faut le coup : la boucle le trouve.
+        if (ply > 0 && (Chebyshev (ctx.pos [me], ctx.pos [other]) == 1 || (ctx.redCell != KNoCell && Chebyshev (ctx.pos [me], ctx.posRed) == 1)))
+            return KWin - int (ply) - 1;
+        //! Résultat acquis : la position est terminale, comme quand les tours sont épuisés. Le carré rouge peut encore apparaitre tant qu'il ne l'a pas fait.
+        if (ply > 0 && ResultDecided (ctx.pos [0], ctx.pos [1], ctx.score [0] - ctx.score [1], ctx.compteTour, ctx.side + 1,
+                                      ctx.redCell != KNoCell ? &ctx.posRed : nullptr, ctx.redCell == KNoCell && ctx.game->doesRedSquare)){
+            const int diff (ctx.score [me] - ctx.score [other]);
+            return (diff > 0) ? KWin - int (ply) : (diff < 0) ? -(KWin - int (ply)) : 0;
+        }
+        if (depth <= 0 || ply + 1 >= KMaxPly) return Evaluate (ctx);
+
+        const int alphaOrig (alpha);
+        CTTEntry & entry (ctx.bot->table [ctx.hash & (ctx.bot->table.size () - 1)]);
+        unsigned char ttMove (255);
+        if (entry.key == ctx.hash){
+            ttMove = entry.move;
+            if (entry.depth >= depth){
+                //! Les scores de victoire sont stockés relativement à la position, on les ramène à la racine.
+                int score (entry.score);
+                if (score >  KWin - int (KMaxPly)) score -= ply;
+                if (score < -KWin + int (KMaxPly)) score += ply;
+                if (entry.bound == KBoundExact) return score;
+                if (entry.bound == KBoundLower && score >= beta)  return score;
+                if (entry.bound == KBoundUpper && score <= alpha) return score;
+            }
+        }
+
+        //! Ordre des coups : celui de la table, puis les pièces, puis ceux qui se rapprochent de l'adversaire.
+        const unsigned legal (LegalMoves (ctx.pos [me], ctx.game->matrixSize));
+        unsigned order [8], nbMoves (0);
+        int      key   [8];
+        for (unsigned k(0); k < 8; ++k){
+            if (!(legal & (1u << k))) continue;
+            const CPosition dest (Destination (KMoveKeys [k], ctx.pos [me]));
+            int orderKey (-int (Chebyshev (dest, ctx.pos [other])));
+            if (k == ttMove) orderKey += 100000;
+            if (dest == ctx.pos [other] || (dest == ctx.posRed && ctx.redCell != KNoCell)) orderKey += 1000000;
+            if (IsCoinLeft (ctx, ctx.game->mat.Index (dest.first, dest.second))) orderKey += 1000;
+            unsigned i (nbMoves++);
+            for (; i > 0 && key [i - 1] < orderKey; --i){
+                order [i] = order [i - 1];
+                key   [i] = key   [i - 1];
+            }
+            order [i] = k;
+            key   [i] = orderKey;
+        }
+
+        int bestScore (-KWin - 1);
+        unsigned char bestMove (order [0]);
+        for (unsigned m(0); m < nbMoves; ++m){
+            const unsigned  k    (order [m]);
+            const CPosition from (ctx.pos [me]);
+            const CPosition dest (Destination (KMoveKeys [k], from));
+            int score;
+
+            if (dest == ctx.pos [other] || (dest == ctx.posRed && ctx.redCell != KNoCell))
+                score = KWin - int (ply) - 1;
+            else {
+                const size_t fromCell (ctx.game->mat.Index (from.first, from.second));
+                const size_t destCell (ctx.game->mat.Index (dest.first, dest.second));
+                const bool   taken    (IsCoinLeft (ctx, destCell));
+                const uint64_t hashBefore (ctx.hash);
+                const unsigned tourBefore (ctx.compteTour);
+
+                ctx.pos [me] = dest;
+                ctx.hash ^= ZobristKey (me, fromCell) ^ ZobristKey (me, destCell) ^ ZobristKey (5, 0);
+                if (taken){
+                    ctx.VTaken [ctx.nbTaken++] = destCell;
+                    ++ctx.score [me];
+                    ctx.hash ^= ZobristKey (2 + me, destCell);
+                }
+                if (me == 1){
+                    --ctx.compteTour;
+                    ctx.hash ^= ZobristKey (4, tourBefore) ^ ZobristKey (4, ctx.compteTour);
+                }
+                ctx.side = other;
+
+                if (ctx.compteTour == 0){
+                    //! Plus de tours : le plus de points l'emporte.
+                    const int diff (ctx.score [me] - ctx.score [other]);
+                    score = (diff > 0) ? KWin - int (ply) - 1 : (diff < 0) ? -(KWin - int (ply) - 1) : 0;
+                }
+                //! Finir à côté de l'adversaire lui offre la capture, s'il lui reste un coup : le dernier coup de la partie ne risque rien.
+                else if (Chebyshev (dest, ctx.pos [other]) == 1)
+                    score = -(KWin - int (ply) - 2);
+                else
+                    score = -Negamax (ctx, depth - 1, -beta, -alpha, ply + 1);
+
+                ctx.side       = me;
+                ctx.compteTour = tourBefore;
+                ctx.hash       = hashBefore;
+                ctx.pos [me]   = from;
+                if (taken){
+                    --ctx.nbTaken;
+                    --ctx.score [me];
+                }
+            }
+            if (ctx.stop) return 0;
+
+            if (score > bestScore){
+                bestScore = score;
+                bestMove  = k;
+            }
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) break;
+        }
+
+        int stored (bestScore);
+        if (stored >  KWin - int (KMaxPly)) stored += ply;
+        if (stored < -KWin + int (KMaxPly)) stored -= ply;
+        entry.key   = ctx.hash;
+        entry.score = stored;
+        entry.depth = depth;
+        entry.move  = bestMove;
+        entry.bound = (bestScore <= alphaOrig) ? KBoundUpper : (bestScore >= beta) ? KBoundLower : KBoundExact;
+        return bestScore;
+    } // Negamax ()
+
+    /*!
+     * \fn void InitSearchBot (CSearchBot & bot, const unsigned & budgetMs)
+     * \brief Prépare un joueur ordinateur : table de transposition vide de 2^18 entrées et budget de temps par coup.
+     */
+    void InitSearchBot (CSearchBot & bot, const unsigned & budgetMs){
+        bot.table.assign (size_t (1) << 18, CTTEntry ());
+        bot.budgetMs = budgetMs;
+    } // InitSearchBot ()
+
+    /*!
+     * \fn char SearchMove (CSearchBot & bot, const CGameState & game)
+     * \brief Choisit le coup du joueur qui a le trait par approfondissement itératif, dans la limite du budget de temps du joueur.
+     * Le coup de la dernière profondeur terminée est joué.
+     */
+    char SearchMove (CSearchBot & bot, const CGameState & game){
+        //! Sur les petites grilles, la table de finales donne le coup parfait sans chercher.
+        char forced;
+        if (TablebaseProbe (game, forced) != 0) return forced;
+
+        CSearchContext ctx;
+        ctx.game       = &game;
+        ctx.bot        = &bot;
+        ctx.pos [0]    = game.posPlayer1;
+        ctx.pos [1]    = game.posPlayer2;
+        ctx.side       = game.turn - 1;
+        ctx.compteTour = game.compteTour;
+        ctx.score [0]  = game.VScore [0];
+        ctx.score [1]  = game.VScore [1];
+        ctx.redCell    = game.doesRedSquare ? KNoCell : game.mat.Index (game.posRedSquare.first, game.posRedSquare.second);
+        ctx.posRed     = game.posRedSquare;
+        ctx.nbTaken    = 0;
+        ctx.nodes      = 0;
+        ctx.stop       = false;
+        ctx.deadline   = chrono::steady_clock::now () + chrono::milliseconds (bot.budgetMs);
+
+        //! La table de transposition sert tout au long de la partie : la clé comprend aussi ce qui change entre deux coups sans que la recherche le joue
+        //! (pièces apparues, carré rouge, points déjà marqués), pour qu'une entrée d'un coup précédent ne soit reprise que dans la même situation.
+        uint64_t coinHash (0);
+        //! Seules les pièces les plus proches des joueurs comptent dans l'évaluation : la recherche ne dépend pas du nombre de pièces sur la grille.
+        ctx.nbCandidates = 0;
+        vector<pair<unsigned, size_t> > VNearest;
+        for (const size_t & cell : game.VPosCoin.cells){
+            const CPosition pos (CellPosition (cell, game.matrixSize));
+            VNearest.push_back (make_pair (min (Chebyshev (pos, ctx.pos [0]), Chebyshev (pos, ctx.pos [1])), cell));
+            coinHash ^= ZobristKey (6, cell);
+        }
+        if (VNearest.size () > KMaxCandidateCoins){
+            nth_element (VNearest.begin (), VNearest.begin () + KMaxCandidateCoins, VNearest.end ());
+            VNearest.resize (KMaxCandidateCoins);
+        }
+        for (const pair<unsigned, size_t> & near : VNearest){
+            ctx.VCandidateCell [ctx.nbCandidates] = near.second;
+            ctx.VCandidate [ctx.nbCandidates++]   = CellPosition (near.second, game.matrixSize);
+        }
+
+        ctx.hash = ZobristKey (0, game.mat.Index (ctx.pos [0].first, ctx.pos [0].second))
+                 ^ ZobristKey (1, game.mat.Index (ctx.pos [1].first, ctx.pos [1].second))
+                 ^ ZobristKey (4, ctx.compteTour) ^ (ctx.side == 1 ? ZobristKey (5, 0) : 0)
+                 ^ coinHash ^ ZobristKey (7, ctx.redCell) ^ ZobristKey (8, uint64_t (int64_t (ctx.score [0] - ctx.score [1])));
+
+        const unsigned legal (LegalMoves (ctx.pos [ctx.side], game.matrixSize));
+        char best (KMoveKeys [__builtin_ctz (legal)]);
+        const unsigned maxDepth (min (KMaxPly - 2, 2 * ctx.compteTour));
+        for (unsigned depth(1); depth <= maxDepth; ++depth){
+            const int score (Negamax (ctx, depth, -KWin - 1, KWin + 1, 0));
+            if (ctx.stop) break;
+            const CTTEntry & entry (bot.table [ctx.hash & (bot.table.size () - 1)]);
+            if (entry.key == ctx.hash && entry.move < 8)
+                best = KMoveKeys [entry.move];
+            //! Une victoire ou une défaite forcée est connue : inutile de chercher plus loin.
+            if (score > KWin - int (KMaxPly) || score < -KWin + int (KMaxPly)) break;
+        }
+        return best;
+    } // SearchMove ()
+
+    /*!
+     * \fn void RunParallel (const unsigned & nbTasks, const unsigned & nbThreads, const function<void (unsigned, unsigned)> & job)
+     * \brief Exécute job (tâche, worker) pour chaque tâche sur un pool de threads à vol de travail.
+     * Chaque worker dépile ses propres tâches par la fin de sa file et, quand elle est vide, vole les tâches des autres par le début.
+     */
+    void RunParallel (const unsigned & nbTasks, const unsigned & nbThreads, const function<void (unsigned, unsigned)> & job){
+        struct CQueue {
+            mutex          lock;
+            deque<unsigned> tasks;
+        };
+        vector<CQueue> VQueue (nbThreads);
+
+        //! Répartition initiale en blocs contigus, un par worker.
+        for (unsigned task(0); task < nbTasks; ++task)
+            VQueue [(unsigned long long) task * nbThreads / nbTasks].tasks.push_back (task);
+
+        auto worker = [&] (unsigned self){
+            for (;;){
+                unsigned task (0);
+                bool     found (false);
+                {
+                    lock_guard<mutex> guard (VQueue [self].lock);
+                    if (!VQueue [self].tasks.empty ()){
+                        task = VQueue [self].tasks.back ();
+                        VQueue [self].tasks.pop_back ();
+                        found = true;
+                    }
+                }
+                for (unsigned k(1); !found && k < nbThreads; ++k){
+                    CQueue & victim (VQueue [(self + k) % nbThreads]);
+                    lock_guard<mutex> guard (victim.lock);
+                    if (!victim.tasks.empty ()){
+                        task = victim.tasks.front ();
+                        victim.tasks.pop_front ();
+                        found = true;
+                    }
+                }
+                //! Aucune tâche n'est créée en cours de route : si toutes les files sont vides, le travail est fini.
+                if (!found) return;
+                job (task, self);
+            }
+        };
+
+        vector<thread> VThread;
+        for (unsigned self(1); self < nbThreads; ++self)
+            VThread.emplace_back (worker, self);
+        worker (0);
+        for (thread & th : VThread)
+            th.join ();
+    } // RunParallel ()
+
+    //! Nombre maximal de demi-coups d'une simulation Monte-Carlo, descente dans l'arbre comprise. Au-delà, la partie est jugée aux points.
+    const unsigned KPlayoutPlies = 128;
+    //! Constante d'exploration de la formule UCT.
+    const double KUctExploration = 1.4;
+
+    /*!
+     * \struct CMctsNode
+     * \brief Noeud de l'arbre Monte-Carlo. L'arbre est en boucle ouverte : un noeud représente une suite de coups, quelles que soient les apparitions tirées.
+     * Les positions des joueurs n'en dépendent pas, les coups possibles d'un noeud sont donc toujours les mêmes.
+     * \var wins demi-points gagnés par le joueur qui a joué le coup menant au noeud (2 par victoire, 1 par match nul).
+     * \var virtualLoss simulations en cours sous ce noeud, comptées comme perdues pour que les autres threads explorent ailleurs.
+     * \var firstChild indice des 8 fils dans la réserve (un par touche de KMoveKeys), 0 tant que le noeud n'est pas développé.
+     */
+    struct CMctsNode {
+        atomic<uint32_t> visits;
+        atomic<uint32_t> wins;
+        atomic<uint32_t> virtualLoss;
+        atomic<uint32_t> firstChild;
+        atomic<bool>     expanding;
+    };
+
+    /*!
+     * \struct CMctsBot
+     * \brief Joueur ordinateur Monte-Carlo : réserve de noeuds allouée une fois pour toutes, budget de temps par coup et nombre de threads.
+     */
+    struct CMctsBot {
+        vector<CMctsNode> pool;
+        atomic<uint32_t>  nbNodes;
+        unsigned          budgetMs;
+        unsigned          nbThreads;
+    };
+
+    /*!
+     * \struct CPlayout
+     * \brief État d'une simulation, entièrement sur la pile. Les pièces du plateau réel restent dans le plan de la partie :
+     * seules celles ramassées (VTaken) et apparues (VSpawned) pendant la simulation sont listées.
+     */
+    struct CPlayout {
+        const CGameState * game;
+        CPosition          pos [2];
+        unsigned           side;
+        unsigned           compteTour;
+        unsigned           score [2];
+        unsigned           winner;
+        bool               hasRed;
+        CPosition          posRed;
+        size_t             VTaken [KPlayoutPlies];
+        unsigned           nbTaken;
+        size_t             VSpawned [KPlayoutPlies];
+        unsigned           nbSpawned;
+        unsigned           plies;
+        CRng *             rng;
+    };
+
+    /*!
+     * \fn bool PlayoutCoin (const CPlayout & play, const size_t & cell, unsigned * spawnedSlot)
+     * \brief Indique s'il y a une pièce sur la case dans la simulation. spawnedSlot reçoit sa place dans VSpawned si elle y est apparue.
+     */
+    bool PlayoutCoin (const CPlayout & play, const size_t & cell, unsigned * spawnedSlot){
+        for (unsigned i(0); i < play.nbSpawned; ++i)
+            if (play.VSpawned [i] == cell){
+                if (spawnedSlot) *spawnedSlot = i;
+                return true;
+            }
+        if (!play.game->planes [KPlaneCoin].Test (cell)) return false;
+        for (unsigned i(0); i < play.nbTaken; ++i)
+            if (play.VTaken [i] == cell) return false;
+        if (spawnedSlot) *spawnedSlot = KPlayoutPlies;
+        return true;
+    } // PlayoutCoin ()
+
+    /*!
+     * \fn bool PlayoutSpawnCell (CPlayout & play, size_t & cell)
+     * \brief Tire une case libre pour une apparition. Quelques tirages dans toute la grille suffisent tant qu'elle n'est pas presque pleine.
+     */
+    bool PlayoutSpawnCell (CPlayout & play, size_t & cell){
+        const CGameState & game (*play.game);
+        const size_t       nbCells (game.mat.cells.size ());
+        for (unsigned attempt(0); attempt < 8; ++attempt){
+            cell = (nbCells <= UINT_MAX) ? RandomBelow (*play.rng, nbCells) : (*play.rng) () % nbCells;
+            const CPosition pos (CellPosition (cell, game.matrixSize));
+            if (pos == play.pos [0] || pos == play.pos [1] || (play.hasRed && pos == play.posRed)) continue;
+            if (PlayoutCoin (play, cell, nullptr)) continue;
+            return true;
+        }
+        return false;
+    } // PlayoutSpawnCell ()
+
+    /*!
+     * \fn void PlayoutStep (CPlayout & play, const unsigned & k)
+     * \brief Joue le coup KMoveKeys [k] (déjà reconnu possible) avec les règles de Step (), y compris les apparitions tirées avec game.chance.
+     */
+    void PlayoutStep (CPlayout & play, const unsigned & k){
+        const unsigned me (play.side);
+        play.pos [me] = Destination (KMoveKeys [k], play.pos [me]);
+        ++play.plies;
+
+        if (play.pos [0] == play.pos [1] || (play.hasRed && play.pos [me] == play.posRed)){
+            play.winner = me + 1;
+            return;
+        }
+        const size_t cell (play.game->mat.Index (play.pos [me].first, play.pos [me].second));
+        unsigned slot;
+        if (PlayoutCoin (play, cell, &slot)){
+            ++play.score [me];
+            if (slot < KPlayoutPlies)
+                play.VSpawned [slot] = play.VSpawned [--play.nbSpawned];
+            else
+                play.VTaken [play.nbTaken++] = cell;
+        }
+        if (me == 1) --play.compteTour;
+        play.side = 1 - me;
+        if (play.compteTour == 0) return;
+
+        //! Apparitions du coup suivant, dans le même ordre que SpawnTokens ().
+        const unsigned chance (play.game->chance);
+        size_t spawn;
+        if (!play.hasRed && RandomBelow (*play.rng, 100) < chance && PlayoutSpawnCell (play, spawn)){
+            play.hasRed = true;
+            play.posRed = CellPosition (spawn, play.game->matrixSize);
+        }
+        if (RandomBelow (*play.rng, 100) < chance && PlayoutSpawnCell (play, spawn))
+            play.VSpawned [play.nbSpawned++] = spawn;
+    } // PlayoutStep ()
+
+    /*!
+     * \fn bool PlayoutOver (const CPlayout & play)
+     * \brief Indique si la simulation est finie : victoire, plus de tours ou limite de KPlayoutPlies demi-coups.
+     */
+    bool PlayoutOver (const CPlayout & play){
+        return play.winner != 0 || play.compteTour == 0 || play.plies >= KPlayoutPlies;
+    } // PlayoutOver ()
+
+    /*!
+     * \fn unsigned PlayoutPolicy (CPlayout & play)
+     * \brief Coup d'une simulation : une victoire immédiate si elle existe, sinon un coup au hasard qui ne finit pas à côté de l'adversaire, de préférence sur une pièce.
+     */
+    unsigned PlayoutPolicy (CPlayout & play){
+        const CPosition & pos   (play.pos [play.side]);
+        const CPosition & other (play.pos [1 - play.side]);
+        const unsigned    legal (LegalMoves (pos, play.game->matrixSize));
+
+        unsigned safe (0), coins (0);
+        for (unsigned k(0); k < 8; ++k){
+            if (!(legal & (1u << k))) continue;
+            const CPosition dest (Destination (KMoveKeys [k], pos));
+            if (dest == other || (play.hasRed && dest == play.posRed)) return k;
+            if (Chebyshev (dest, other) <= 1) continue;
+            safe |= 1u << k;
+            if (PlayoutCoin (play, play.game->mat.Index (dest.first, dest.second), nullptr)) coins |= 1u << k;
+        }
+        unsigned choice (coins ? coins : safe ? safe : legal);
+        //! Tirage uniforme d'un bit de choice.
+        for (unsigned skip (RandomBelow (*play.rng, __builtin_popcount (choice))); skip > 0; --skip)
+            choice &= choice - 1;
+        return __builtin_ctz (choice);
+    } // PlayoutPolicy ()
+
+    /*!
+     * \fn unsigned PlayoutWinner (const CPlayout & play)
+     * \brief Vainqueur d'une simulation finie (1 ou 2), 0 pour un match nul. Une simulation arrêtée avant la fin est jugée aux points.
+     */
+    unsigned PlayoutWinner (const CPlayout & play){
+        if (play.winner != 0) return play.winner;
+        return (play.score [0] > play.score [1]) ? 1 : (play.score [0] < play.score [1]) ? 2 : 0;
+    } // PlayoutWinner ()
+
+    /*!
+     * \fn void ResetNode (CMctsNode & node)
+     * \brief Remet un noeud de la réserve à zéro avant de l'utiliser.
+     */
+    void ResetNode (CMctsNode & node){
+        node.visits.store (0, memory_order_relaxed);
+        node.wins.store (0, memory_order_relaxed);
+        node.virtualLoss.store (0, memory_order_relaxed);
+        node.firstChild.store (0, memory_order_relaxed);
+        node.expanding.store (false, memory_order_relaxed);
+    } // ResetNode ()
+
+    /*!
+     * \fn void InitMctsBot (CMctsBot & bot, const unsigned & budgetMs, const unsigned & nbThreads)
+     * \brief Prépare un joueur Monte-Carlo : réserve de 2^20 noeuds, budget de temps par coup et nombre de threads (au moins 1).
+     */
+    void InitMctsBot (CMctsBot & bot, const unsigned & budgetMs, const unsigned & nbThreads){
+        bot.pool      = vector<CMctsNode> (size_t (1) << 20);
+        bot.budgetMs  = budgetMs;
+        bot.nbThreads = max (nbThreads, 1u);
+    } // InitMctsBot ()
+
+    /*!
+     * \fn void MctsIteration (CMctsBot & bot, const CPlayout & root)
+     * \brief Une itération : descente UCT avec perte virtuelle, développement du noeud atteint, simulation jusqu'à la fin, remontée du résultat.
+     * Tous les threads partagent l'arbre sans verrou : les compteurs sont atomiques et un seul thread développe chaque noeud.
+     */
+    void MctsIteration (CMctsBot & bot, const CPlayout & root){
+        CPlayout  play (root);
+        uint32_t  VPath [KPlayoutPlies + 1];
+        unsigned  VMover [KPlayoutPlies + 1];
+        unsigned  length (1);
+        VPath [0]  = 0;
+        VMover [0] = 2;
+
+        uint32_t node (0);
+        while (!PlayoutOver (play)){
+            const uint32_t first (bot.pool [node].firstChild.load (memory_order_acquire));
+            if (first == 0){
+                //! Développement : le premier thread qui arrive réserve les 8 fils, les autres simulent depuis ce noeud.
+                bool expected (false);
+                if (bot.pool [node].visits.load (memory_order_relaxed) > 0 && bot.pool [node].expanding.compare_exchange_strong (expected, true)){
+                    const uint32_t child (bot.nbNodes.fetch_add (8, memory_order_relaxed));
+                    if (child + 8 <= bot.pool.size ()){
+                        for (unsigned k(0); k < 8; ++k)
+                            ResetNode (bot.pool [child + k]);
+                        bot.pool [node].firstChild.store (child, memory_order_release);
+                    }
+                }
+                break;
+            }
+
+            //! Sélection UCT parmi les coups possibles ; un fils jamais visité passe avant les autres.
+            const unsigned legal   (LegalMoves (play.pos [play.side], play.game->matrixSize));
+            const double   logN    (log (double (bot.pool [node].visits.load (memory_order_relaxed)) + 1.0));
+            unsigned       best    (__builtin_ctz (legal));
+            double         bestUct (-1.0);
+            for (unsigned k(0); k < 8; ++k){
+                if (!(legal & (1u << k))) continue;
+                const CMctsNode & child (bot.pool [first + k]);
+                const double n (double (child.visits.load (memory_order_relaxed)) + child.virtualLoss.load (memory_order_relaxed));
+                const double uct ((n == 0) ? 1e9 + RandomBelow (*play.rng, 1024)
+                                           : child.wins.load (memory_order_relaxed) / (2.0 * n) + KUctExploration * sqrt (logN / n));
+                if (uct > bestUct){
+                    bestUct = uct;
+                    best    = k;
+                }
+            }
+            node = first + best;
+            bot.pool [node].virtualLoss.fetch_add (1, memory_order_relaxed);
+            VMover [length] = play.side;
+            VPath [length++] = node;
+            PlayoutStep (play, best);
+        }
+
+        while (!PlayoutOver (play))
+            PlayoutStep (play, PlayoutPolicy (play));
+        const unsigned winner (PlayoutWinner (play));
+
+        for (unsigned i(0); i < length; ++i){
+            CMctsNode & visited (bot.pool [VPath [i]]);
+            visited.visits.fetch_add (1, memory_order_relaxed);
+            if (winner == 0)                 visited.wins.fetch_add (1, memory_order_relaxed);
+            else if (winner == VMover [i] + 1) visited.wins.fetch_add (2, memory_order_relaxed);
+            if (i > 0) visited.virtualLoss.fetch_sub (1, memory_order_relaxed);
+        }
+    } // MctsIteration ()
+
+    /*!
+     * \fn char MctsMove (CMctsBot & bot, const CGameState & game)
+     * \brief Choisit le coup du joueur qui a le trait par recherche Monte-Carlo sur bot.nbThreads threads pendant bot.budgetMs millisecondes.
+     * Le coup le plus visité est joué. Aucune allocation n'a lieu pendant la recherche : l'état des simulations est sur la pile et les noeuds dans la réserve.
+     */
+    char MctsMove (CMctsBot & bot, const CGameState & game){
+        char forced;
+        if (TablebaseProbe (game, forced) != 0) return forced;
+
+        CPlayout root;
+        root.game       = &game;
+        root.pos [0]    = game.posPlayer1;
+        root.pos [1]    = game.posPlayer2;
+        root.side       = game.turn - 1;
+        root.compteTour = game.compteTour;
+        root.score [0]  = game.VScore [0];
+        root.score [1]  = game.VScore [1];
+        root.winner     = 0;
+        root.hasRed     = !game.doesRedSquare;
+        root.posRed     = game.posRedSquare;
+        root.nbTaken    = root.nbSpawned = root.plies = 0;
+        root.rng        = nullptr;
+
+        ResetNode (bot.pool [0]);
+        bot.nbNodes.store (1, memory_order_relaxed);
+        const chrono::steady_clock::time_point deadline (chrono::steady_clock::now () + chrono::milliseconds (bot.budgetMs));
+
+        RunParallel (bot.nbThreads, bot.nbThreads, [&] (unsigned task, unsigned){
+            CRng rng;
+            rng.Seed (MatchSeed (game.seed ^ game.VMove.size (), task));
+            CPlayout start (root);
+            start.rng = &rng;
+            do {
+                for (unsigned i(0); i < 64; ++i)
+                    MctsIteration (bot, start);
+            } while (chrono::steady_clock::now () < deadline);
+        });
+
+        const unsigned legal (LegalMoves (root.pos [root.side], game.matrixSize));
+        const uint32_t first (bot.pool [0].firstChild.load (memory_order_acquire));
+        unsigned best (__builtin_ctz (legal));
+        if (first != 0)
+            for (unsigned k(0); k < 8; ++k)
+                if ((legal & (1u << k)) && bot.pool [first + k].visits > bot.pool [first + best].visits)
+                    best = k;
+        return KMoveKeys [best];
+    } // MctsMove ()
+
+    /*!
+     * \fn void RunBatch (const CVPairStr & VNameColor, const unsigned & matrixSize, const uint64_t & baseSeed, unsigned nbThreads, vector<CMatchResult> & VResult)
+     * \brief Joue sans affichage toutes les parties des couples de VNameColor entre joueurs ordinateur, réparties sur nbThreads threads.
+     * Chaque worker a sa propre grille et ses propres générateurs, réinitialisés pour chaque partie à partir de baseSeed et du numéro de la partie :
+     * les résultats ne dépendent pas du nombre de threads. VResult reçoit le résultat de chaque partie dans l'ordre des couples.
+     */
+    void RunBatch (const CVPairStr & VNameColor, const unsigned & matrixSize, const uint64_t & baseSeed, unsigned nbThreads, vector<CMatchResult> & VResult){
+        const unsigned nbMatches (VNameColor.size () / 2);
+        if (nbThreads == 0) nbThreads = 1;
+        if (nbThreads > nbMatches) nbThreads = max (nbMatches, 1u);
+
+        vector<CGameState> VGame (nbThreads);
+        vector<CRng>       VBotRng (nbThreads);
+        VResult.assign (nbMatches, CMatchResult ());
+
+        RunParallel (nbMatches, nbThreads, [&] (unsigned match, unsigned self){
+            CGameState & game   (VGame [self]);
+            CRng       & botRng (VBotRng [self]);
+            const uint64_t seed (MatchSeed (baseSeed, match));
+            game.telemetry = SharedTelemetry ();
+            game.earlyEnd  = true;
+            InitGame (game, matrixSize, seed);
+            botRng.Seed (~seed);
+            while (!IsOver (game))
+                Step (game, BotMove (game, botRng));
+
+            //! Chaque partie écrit dans sa propre case : pas besoin de verrou.
+            VResult [match] = MatchResult (game, VNameColor [2 * match].first, VNameColor [2 * match + 1].first);
+        });
+    } // RunBatch ()
+
+    const char     KCastMagic [8] = {'C', 'M', 'I', 'Y', 'C', 'C', 'A', 'S'};
+    const uint32_t KCastVersion   = 2;
+    //! Emplacements de l'anneau : un spectateur qui a plus de KCastSlots états de retard passe directement au dernier.
+    const uint32_t KCastSlots     = 256;
+
+    /*!
+     * \struct CCastState
+     * \brief État publié après chaque coup : de quoi afficher la partie (noms, couleurs, pions, scores, tours) et de quoi reconstruire
+     * la grille en rejouant les nbMoves premiers coups de CCastHeader::moves à partir de la graine.
+     */
+    struct CCastState {
+        uint64_t match;
+        uint64_t seed;
+        uint32_t matrixSize;
+        uint32_t nbMoves;
+        uint32_t score [2];
+        uint32_t compteTour;
+        uint8_t  turn;
+        uint8_t  winner;
+        uint8_t  timeForfeit;
+        //! La partie s'arrête dès que son résultat est acquis (CGameState::earlyEnd) : le spectateur la rejoue de la même façon.
+        uint8_t  earlyEnd;
+        char     token [2];
+        uint8_t  reserved [6];
+        char     colors [2][8];
+        char     names [2][32];
+    };
+    static_assert (sizeof (CCastState) == 128, "format de la diffusion");
+
+    /*!
+     * \struct CCastSlot
+     * \brief Emplacement de l'anneau, protégé par un compteur de séquence : 2 * numéro + 1 pendant l'écriture de l'état numéro, 2 * numéro + 2 une fois écrit.
+     */
+    struct CCastSlot {
+        atomic<uint64_t> sequence;
+        CCastState       state;
+    };
+
+    /*!
+     * \struct CCastHeader
+     * \brief Début du segment de mémoire partagée (--broadcast) : anneau de KCastSlots états écrit par la partie, lu par les spectateurs (--spectate),
+     * puis coups de la partie en cours. Le producteur n'attend jamais les lecteurs.
+     */
+    struct CCastHeader {
+        char             magic [8];
+        uint32_t         version;
+        uint32_t         maxMoves;
+        //! Nombre d'états publiés : le dernier est dans slots [(head - 1) % KCastSlots].
+        atomic<uint64_t> head;
+        //! Partie dont les coups sont dans moves, changée avant que ses premiers coups n'y soient écrits.
+        atomic<uint64_t> match;
+        //! La partie qui diffusait est terminée.
+        atomic<uint32_t> closed;
+        CCastSlot        slots [KCastSlots];
+    };
+
+    /*!
+     * \struct CBroadcast
+     * \brief Diffusion de ce processus : segment projeté, nom et nombre de parties diffusées.
+     */
+    struct CBroadcast {
+        CCastHeader * header;
+        char *        moves;
+        size_t        size;
+        string        name;
+        uint64_t      nbMatches;
+    };
+
+    //! Diffusion active (--broadcast), header == nullptr sinon.
+    CBroadcast Broadcast = {nullptr, nullptr, 0, string (), 0};
+
+    /*!
+     * \fn string CastName (const string & name)
+     * \brief Nom POSIX du segment de mémoire partagée d'une diffusion.
+     */
+    string CastName (const string & name){
+        return "/cmiyc-" + name;
+    } // CastName ()
+
+    /*!
+     * \fn void StopBroadcast ()
+     * \brief Signale aux spectateurs que la diffusion est finie et retire le segment. Ceux qui l'ont projeté le gardent jusqu'à ce qu'ils le quittent.
+     */
+    void StopBroadcast (){
+        if (!Broadcast.header) return;
+        Broadcast.header->closed.store (1, memory_order_release);
+        munmap (Broadcast.header, Broadcast.size);
+        shm_unlink (CastName (Broadcast.name).c_str ());
+        Broadcast.header = nullptr;
+    } // StopBroadcast ()
+
+    /*!
+     * \fn bool StartBroadcast (const string & name, const unsigned & matrixSize)
+     * \brief Crée le segment de mémoire partagée de la diffusion name, pour des parties de taille matrixSize. Il est retiré à la sortie du programme.
+     */
+    bool StartBroadcast (const string & name, const unsigned & matrixSize){
+        //! Au plus deux déplacements par tour.
+        const uint32_t maxMoves (2 * (unsigned (matrixSize * 1.5) + 1));
+        const string   path (CastName (name));
+        shm_unlink (path.c_str ());
+        const int fd (shm_open (path.c_str (), O_RDWR | O_CREAT | O_EXCL, 0644));
+        if (fd < 0) return false;
+        const size_t size (sizeof (CCastHeader) + maxMoves);
+        void * map (ftruncate (fd, size) == 0 ? mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED);
+        close (fd);
+        if (map == MAP_FAILED){
+            shm_unlink (path.c_str ());
+            return false;
+        }
+
+        //! Le segment neuf est rempli de zéros : tous les compteurs partent de 0.
+        Broadcast.header = static_cast<CCastHeader *> (map);
+        Broadcast.moves  = static_cast<char *> (map) + sizeof (CCastHeader);
+        Broadcast.size   = size;
+        Broadcast.name   = name;
+        Broadcast.header->version  = KCastVersion;
+        Broadcast.header->maxMoves = maxMoves;
+        atomic_thread_fence (memory_order_release);
+        memcpy (Broadcast.header->magic, KCastMagic, sizeof (KCastMagic));
+        atexit (StopBroadcast);
+        return true;
+    } // StartBroadcast ()
+
+    /*!
+     * \fn void PublishState (const CGameState & game, const CVPairStr & VPair, const bool & newMatch)
+     * \brief Publie l'état de la partie entre VPair [0] et VPair [1] dans l'anneau, sans attendre aucun spectateur.
+     * \param newMatch la partie commence, ou reprend à un point de reprise : ses coups remplacent ceux de la précédente.
+     */
+    void PublishState (const CGameState & game, const CVPairStr & VPair, const bool & newMatch){
+        CCastHeader * header (Broadcast.header);
+        if (!header) return;
+        if (newMatch){
+            ++Broadcast.nbMatches;
+            header->match.store (Broadcast.nbMatches, memory_order_relaxed);
+            atomic_thread_fence (memory_order_release);
+        }
+        const uint32_t nbMoves (min (uint32_t (game.VMove.size ()), header->maxMoves));
+        //! Une partie reprise (--resume) commence avec des coups déjà joués : ils sont tous copiés. Ensuite, seul le dernier coup est nouveau.
+        if (newMatch)
+            copy (game.VMove.begin (), game.VMove.begin () + nbMoves, Broadcast.moves);
+        else if (nbMoves > 0)
+            Broadcast.moves [nbMoves - 1] = game.VMove [nbMoves - 1];
+
+        CCastState state;
+        memset (&state, 0, sizeof (state));
+        state.match       = Broadcast.nbMatches;
+        state.seed        = game.seed;
+        state.matrixSize  = game.matrixSize;
+        state.nbMoves     = nbMoves;
+        state.score [0]   = game.VScore [0];
+        state.score [1]   = game.VScore [1];
+        state.compteTour  = game.compteTour;
+        state.turn        = game.turn;
+        state.winner      = game.winner;
+        state.timeForfeit = game.timeForfeit;
+        state.earlyEnd    = game.earlyEnd;
+        state.token [0]   = TokenPlayer1;
+        state.token [1]   = TokenPlayer2;
+        for (unsigned i(0); i < 2; ++i){
+            VPair [i].second.copy (state.colors [i], sizeof (state.colors [i]) - 1);
+            VPair [i].first.copy (state.names [i], sizeof (state.names [i]) - 1);
+        }
+
+        const uint64_t record (header->head.load (memory_order_relaxed));
+        CCastSlot & slot (header->slots [record % KCastSlots]);
+        slot.sequence.store (2 * record + 1, memory_order_relaxed);
+        atomic_thread_fence (memory_order_release);
+        memcpy (&slot.state, &state, sizeof (state));
+        slot.sequence.store (2 * record + 2, memory_order_release);
+        header->head.store (record + 1, memory_order_release);
+    } // PublishState ()
+
+    /*!
+     * \fn bool ReadLatestState (const CCastHeader & header, CCastState & state)
+     * \brief Copie le dernier état publié. Renvoie false si rien n'a encore été publié.
+     * Si le producteur réécrit l'emplacement pendant la copie, la copie est recommencée avec l'état suivant.
+     */
+    bool ReadLatestState (const CCastHeader & header, CCastState & state){
+        for (;;){
+            const uint64_t head (header.head.load (memory_order_acquire));
+            if (head == 0) return false;
+            const CCastSlot & slot (header.slots [(head - 1) % KCastSlots]);
+            const uint64_t before (slot.sequence.load (memory_order_acquire));
+            if (before != 2 * head) continue;
+            memcpy (&state, &slot.state, sizeof (state));
+            atomic_thread_fence (memory_order_acquire);
+            if (slot.sequence.load (memory_order_relaxed) == before) return true;
+        }
+    } // ReadLatestState ()
+
+    /*!
+     * \fn int SpectateMain (int argc, char * argv [])
+     * \brief Mode spectateur : --spectate nom. Suit la diffusion nom (--broadcast nom) et affiche la partie à son rythme :
+     * la grille est reconstruite en rejouant les coups publiés, puis affichée comme pour les joueurs.
+     */
+    int SpectateMain (int argc, char * argv []){
+        if (argc < 3){
+            cerr << "Usage : " << argv [0] << " --spectate nom" << endl;
+            return EXIT_FAILURE;
+        }
+        const string path (CastName (argv [2]));
+        int fd (-1);
+        for (bool waiting (false); (fd = shm_open (path.c_str (), O_RDONLY, 0)) < 0; waiting = true){
+            if (!waiting) cout << "En attente de la diffusion " << argv [2] << "..." << endl;
+            this_thread::sleep_for (chrono::milliseconds (200));
+        }
+        struct stat info;
+        void * map (fstat (fd, &info) == 0 && size_t (info.st_size) > sizeof (CCastHeader) ? mmap (nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED);
+        close (fd);
+        const CCastHeader * header (static_cast<const CCastHeader *> (map));
+        if (map == MAP_FAILED || memcmp (header->magic, KCastMagic, sizeof (KCastMagic)) != 0 || header->version != KCastVersion){
+            cerr << "Diffusion " << argv [2] << " illisible." << endl;
+            return EXIT_FAILURE;
+        }
+        const char * moves (static_cast<const char *> (map) + sizeof (CCastHeader));
+
+        CGameState  game;
+        CCastState  state;
+        uint64_t    match (0), shown (0);
+        vector<char> VCopy;
+        ClearScreen ();
+        while (header->closed.load (memory_order_acquire) == 0){
+            if (!ReadLatestState (*header, state) || header->head.load (memory_order_relaxed) == shown){
+                this_thread::sleep_for (chrono::milliseconds (20));
+                continue;
+            }
+            if (state.match != match || state.nbMoves < game.VMove.size ()){
+                game.earlyEnd = state.earlyEnd;
+                InitGame (game, state.matrixSize, state.seed);
+                match = state.match;
+            }
+            //! Les coups manquants sont copiés, puis gardés seulement si la partie n'a pas changé pendant la copie.
+            const size_t from (game.VMove.size ());
+            VCopy.assign (moves + from, moves + max (size_t (state.nbMoves), from));
+            atomic_thread_fence (memory_order_acquire);
+            if (header->match.load (memory_order_relaxed) != state.match) continue;
+            for (const char & move : VCopy)
+                Step (game, move);
+            if (state.winner != 0 && game.winner == 0){
+                game.winner      = state.winner;
+                game.timeForfeit = state.timeForfeit;
+            }
+            shown = header->head.load (memory_order_relaxed);
+
+            TokenPlayer1 = state.token [0];
+            TokenPlayer2 = state.token [1];
+            const CVPairStr VPair = {make_pair (string (state.names [0]), string (state.colors [0])), make_pair (string (state.names [1]), string (state.colors [1]))};
+            ShowMatrix (game, VPair, 0, !IsOver (game));
+            if (IsOver (game))
+                cout << "Partie terminée." << flush;
+        }
+        cout << endl << "Fin de la diffusion." << endl;
+        munmap (map, info.st_size);
+        return 0;
+    } // SpectateMain ()
+
+    /*!
+     * \struct CMatchConfig
+     * \brief Réglages communs à toutes les parties d'une série.
+     */
+    struct CMatchConfig {
+        unsigned matrixSize;
+        //! Temps de réflexion des joueurs ordinateur, en millisecondes par coup.
+        uint64_t botMs;
+        //! Secondes de réflexion de chaque joueur humain pour toute une partie, 0 sans pendule.
+        uint64_t clockSeconds;
+        //! Un joueur humain participe à la série : le terminal est en mode non canonique.
+        bool     hasHuman;
+    };
+
+    /*!
+     * \fn void InitComputers (CSearchBot VBot [2], CMctsBot VMcts [2], const TPlayerKind VPairKind [2], const uint64_t & botMs, const unsigned & nbMctsThreads)
+     * \brief Prépare les joueurs ordinateur d'une partie. Chacun garde sa table de transposition ou son arbre pendant toute la partie.
+     */
+    void InitComputers (CSearchBot VBot [2], CMctsBot VMcts [2], const TPlayerKind VPairKind [2], const uint64_t & botMs, const unsigned & nbMctsThreads){
+        for (unsigned i(0); i < 2; ++i)
+            if (VPairKind [i] == KComputerSearch)
+                InitSearchBot (VBot [i], botMs);
+            else if (VPairKind [i] == KComputerMcts)
+                InitMctsBot (VMcts [i], botMs, nbMctsThreads);
+    } // InitComputers ()
+
+    /*!
+     * \fn void Pause (const bool & hasHuman)
+     * \brief Peu importe ce que l'utilisateur entre, c'est pour mettre le terminal en "pause".
+     */
+    void Pause (const bool & hasHuman){
+        cout << endl << "Appuyez sur une touche pour continuer" << flush;
+        if (hasHuman){
+            char key;
+            ReadKey (key, -1);
+        }
+        else
+            cin.get ();
+    } // Pause ()
+
+    //! Points de reprise (--checkpoint N) : deux fichiers écrits tour à tour, pour qu'une écriture interrompue laisse toujours le précédent intact.
+    const char * const KCheckpointFiles [2] = {"Reprise.a.bin", "Reprise.b.bin"};
+    const char     KCheckpointMagic [8] = {'C', 'M', 'I', 'Y', 'C', 'C', 'K', 'P'};
+    const uint32_t KCheckpointVersion   = 1;
+
+    /*!
+     * \struct CCheckpointHeader
+     * \brief En-tête d'un point de reprise (32 octets) : numéro croissant (le plus grand est le plus récent), taille et somme de contrôle du contenu.
+     */
+    struct CCheckpointHeader {
+        char     magic [8];
+        uint32_t version;
+        uint32_t checksum;
+        uint64_t sequence;
+        uint64_t size;
+    };
+    static_assert (sizeof (CCheckpointHeader) == 32, "format des points de reprise");
+
+    /*!
+     * \struct CMatchProgress
+     * \brief Partie affichée en cours, telle qu'enregistrée au dernier point de reprise : ses coups (la graine redonne la grille) et les pendules.
+     */
+    struct CMatchProgress {
+        vector<char> VMove;
+        long long    VClockMs [2] = {-1, -1};
+    };
+
+    /*!
+     * \struct CCheckpointer
+     * \brief Écriture des points de reprise. La boucle de jeu encode l'état dans front, l'échange avec pending et continue ;
+     * un fil dédié écrit pending sur disque. Si le disque est lent, un point de reprise pas encore écrit est remplacé par le suivant :
+     * le jeu n'attend jamais le disque.
+     */
+    struct CCheckpointer {
+        //! Tours entre deux points de reprise d'une partie affichée, 0 sans points de reprise.
+        unsigned                      everyTurns = 0;
+        //! Encode l'état à sauvegarder à la fin du tampon. Appelé avec sessionLock pris.
+        function<void (string &)>     encode;
+        //! Protège l'état pendant qu'il est encodé ou modifié par plusieurs threads.
+        mutex                         sessionLock;
+        mutex                         lock;
+        condition_variable            wake;
+        string                        front;
+        string                        pending;
+        string                        back;
+        bool                          hasPending = false;
+        bool                          stop       = false;
+        uint64_t                      sequence   = 0;
+        //! Fichier où écrire le prochain point de reprise.
+        unsigned                      slot       = 0;
+        thread                        writer;
+    };
+
+    CCheckpointer Checkpointer;
+
+    /*!
+     * \fn void CheckpointWriter ()
+     * \brief Fil d'écriture : écrit chaque point de reprise reçu dans le fichier qui ne contient pas le précédent, puis le force sur disque.
+     * Avant de s'arrêter, il écrit le dernier point de reprise reçu.
+     */
+    void CheckpointWriter (){
+        unique_lock<mutex> guard (Checkpointer.lock);
+        for (;;){
+            Checkpointer.wake.wait (guard, [] { return Checkpointer.hasPending || Checkpointer.stop; });
+            if (!Checkpointer.hasPending) return;
+            Checkpointer.back.swap (Checkpointer.pending);
+            Checkpointer.hasPending = false;
+            guard.unlock ();
+
+            const int fd (open (KCheckpointFiles [Checkpointer.slot], O_WRONLY | O_CREAT | O_TRUNC, 0644));
+            if (fd >= 0){
+                if (WriteAll (Checkpointer.back, fd) && fdatasync (fd) == 0)
+                    Checkpointer.slot ^= 1;
+                close (fd);
+            }
+            guard.lock ();
+        }
+    } // CheckpointWriter ()
+
+    /*!
+     * \fn void SaveCheckpoint ()
+     * \brief Prend un point de reprise de l'état (Checkpointer.encode) et le confie au fil d'écriture. Sans effet si les points de reprise sont désactivés.
+     * Seul l'encodage en mémoire est fait ici.
+     */
+    void SaveCheckpoint (){
+        if (!Checkpointer.writer.joinable ()) return;
+        lock_guard<mutex> session (Checkpointer.sessionLock);
+        string & front (Checkpointer.front);
+        front.assign (sizeof (CCheckpointHeader), '\0');
+        Checkpointer.encode (front);
+
+        CCheckpointHeader header;
+        memcpy (header.magic, KCheckpointMagic, sizeof (KCheckpointMagic));
+        header.version  = KCheckpointVersion;
+        header.sequence = ++Checkpointer.sequence;
+        header.size     = front.size () - sizeof (header);
+        header.checksum = Checksum (front.data () + sizeof (header), header.size);
+        memcpy (&front [0], &header, sizeof (header));
+        {
+            lock_guard<mutex> guard (Checkpointer.lock);
+            Checkpointer.pending.swap (front);
+            Checkpointer.hasPending = true;
+        }
+        Checkpointer.wake.notify_one ();
+    } // SaveCheckpoint ()
+
+    /*!
+     * \fn void StopCheckpoints ()
+     * \brief Arrête le fil d'écriture après le dernier point de reprise demandé.
+     */
+    void StopCheckpoints (){
+        if (!Checkpointer.writer.joinable ()) return;
+        {
+            lock_guard<mutex> guard (Checkpointer.lock);
+            Checkpointer.stop = true;
+        }
+        Checkpointer.wake.notify_one ();
+        Checkpointer.writer.join ();
+    } // StopCheckpoints ()
+
+    /*!
+     * \fn void StartCheckpoints (const function<void (string &)> & encode, const unsigned & everyTurns, const uint64_t & sequence)
+     * \brief Active les points de reprise : encode sera appelé à chaque SaveCheckpoint (). Le fil d'écriture est arrêté à la sortie du programme.
+     * \param sequence numéro du dernier point de reprise existant, pour que les suivants le remplacent à la reprise.
+     */
+    void StartCheckpoints (const function<void (string &)> & encode, const unsigned & everyTurns, const uint64_t & sequence){
+        Checkpointer.encode     = encode;
+        Checkpointer.everyTurns = everyTurns;
+        Checkpointer.sequence   = sequence;
+        Checkpointer.writer     = thread (CheckpointWriter);
+        atexit (StopCheckpoints);
+    } // StartCheckpoints ()
+
+    /*!
+     * \fn void RemoveCheckpoints ()
+     * \brief Efface les deux fichiers de points de reprise.
+     */
+    void RemoveCheckpoints (){
+        for (const char * path : KCheckpointFiles)
+            unlink (path);
+    } // RemoveCheckpoints ()
+
+    /*!
+     * \fn void FinishCheckpoints ()
+     * \brief La série de parties est terminée : plus rien à reprendre, les points de reprise sont effacés.
+     */
+    void FinishCheckpoints (){
+        if (!Checkpointer.writer.joinable ()) return;
+        StopCheckpoints ();
+        RemoveCheckpoints ();
+    } // FinishCheckpoints ()
+
+    /*!
+     * \fn bool ReadCheckpoint (const char * path, string & payload, uint64_t & sequence)
+     * \brief Lit un point de reprise et vérifie sa signature, sa taille et sa somme de contrôle.
+     */
+    bool ReadCheckpoint (const char * path, string & payload, uint64_t & sequence){
+        ifstream file (path, ios::binary | ios::ate);
+        //! La taille annoncée par l'en-tête n'est pas couverte par la somme de contrôle : elle doit correspondre au fichier avant toute allocation.
+        const streamoff fileSize (file.tellg ());
+        CCheckpointHeader header;
+        if (!file.seekg (0) || fileSize < streamoff (sizeof (header)) || !file.read (reinterpret_cast<char *> (&header), sizeof (header))
+            || memcmp (header.magic, KCheckpointMagic, sizeof (KCheckpointMagic)) != 0 || header.version != KCheckpointVersion
+            || header.size != uint64_t (fileSize) - sizeof (header)) return false;
+        payload.resize (header.size);
+        if (!file.read (&payload [0], header.size) || Checksum (payload.data (), payload.size ()) != header.checksum) return false;
+        sequence = header.sequence;
+        return true;
+    } // ReadCheckpoint ()
+
+    /*!
+     * \fn CMatchResult PlayMatch (CVPairStr VPair, const TPlayerKind VPairKind [2], const CMatchConfig & config, const uint64_t & seed, CTelemetry & matchTelemetry, CMatchProgress & progress)
+     * \brief Joue à l'écran la partie entre VPair [0] (joueur 1) et VPair [1] (joueur 2), annonce le résultat et attend une touche.
+     * \param matchTelemetry reçoit les mesures de la partie si --telemetry est actif.
+     * \param progress coups déjà joués et pendules, si la partie reprend à un point de reprise (aucun coup sinon). Il est mis à jour
+     * tous les Checkpointer.everyTurns tours, juste avant un point de reprise.
+     */
+    CMatchResult PlayMatch (CVPairStr VPair, const TPlayerKind VPairKind [2], const CMatchConfig & config, const uint64_t & seed, CTelemetry & matchTelemetry, CMatchProgress & progress){
+        //! Quand une nouvelle partie commence, le moteur repart d'une grille vide avec les joueurs dans les coins.
+        CGameState game;
+        ResetTelemetry (matchTelemetry);
+        if (SharedTelemetry ()) game.telemetry = &matchTelemetry;
+        //! ResultDecided () ignore les pendules : un joueur humain qui mène peut encore perdre au temps, la partie va alors jusqu'au bout.
+        game.earlyEnd = config.clockSeconds == 0 || (VPairKind [0] != KHuman && VPairKind [1] != KHuman);
+        InitGame (game, config.matrixSize, seed);
+        const unsigned firstTour (game.compteTour);
+        char move;
+        long long VClockMs [2] = {config.clockSeconds ? (long long) config.clockSeconds * 1000 : -1, config.clockSeconds ? (long long) config.clockSeconds * 1000 : -1};
+        //! Reprise : la graine et les coups redonnent la grille telle qu'au point de reprise.
+        if (!progress.VMove.empty ()){
+            for (const char & played : progress.VMove)
+                Step (game, played);
+            VClockMs [0] = progress.VClockMs [0];
+            VClockMs [1] = progress.VClockMs [1];
+        }
+        unsigned savedTour (game.compteTour);
+
+        CSearchBot VBot [2];
+        CMctsBot   VMcts [2];
+        InitComputers (VBot, VMcts, VPairKind, config.botMs, thread::hardware_concurrency ());
+        PublishState (game, VPair, true);
+
+        while (!IsOver (game)){
+            //! Point de reprise tous les Checkpointer.everyTurns tours complets.
+            if (Checkpointer.everyTurns && game.turn == 1 && game.compteTour != savedTour && (firstTour - game.compteTour) % Checkpointer.everyTurns == 0){
+                {
+                    lock_guard<mutex> guard (Checkpointer.sessionLock);
+                    progress.VMove        = game.VMove;
+                    progress.VClockMs [0] = VClockMs [0];
+                    progress.VClockMs [1] = VClockMs [1];
+                }
+                SaveCheckpoint ();
+                savedTour = game.compteTour;
+            }
+
+            //! Affiche la grille, les tours restants et le joueur qui doit jouer.
+            ShowMatrix (game, VPair, 0, true);
+
+            if (VPairKind [game.turn - 1] == KComputerSearch){
+                Step (game, SearchMove (VBot [game.turn - 1], game));
+                PublishState (game, VPair, false);
+                continue;
+            }
+            if (VPairKind [game.turn - 1] == KComputerMcts){
+                Step (game, MctsMove (VMcts [game.turn - 1], game));
+                PublishState (game, VPair, false);
+                continue;
+            }
+
+            //! 667. Saisie de la valeur du déplacement. La pendule du joueur tourne pendant qu'il réfléchit.
+            long long & clockMs (VClockMs [game.turn - 1]);
+            //! Avec --tablebase, le joueur humain voit le coup parfait quand l'issue est forcée.
+            char hint;
+            const int forced (TablebaseProbe (game, hint));
+            if (forced > 0)
+                cout << endl << "Conseil : " << hint << " (victoire forcée en " << (forced + 1) / 2 << " coup" << ((forced > 1) ? "s)" : ")");
+            else if (forced < 0)
+                cout << endl << "Conseil : " << hint << " (défaite inévitable, au mieux dans " << -forced / 2 << " coup" << ((forced < -2) ? "s adverses)" : " adverse)");
+            if (!PromptMove (move, clockMs, game.telemetry)){
+                Forfeit (game);
+                break;
+            }
+
+            //! 680. Le moteur déplace le pion et applique les règles (capture, carré rouge, pièces).
+            MoveToken (game, move, clockMs);
+            PublishState (game, VPair, false);
+        } // while ()
+        //! Un forfait ne passe pas par Step : l'état final est republié.
+        PublishState (game, VPair, false);
+        ShowMatrix (game, VPair, 0, false);
+
+        if (game.winner == 0){
+            //! 705. Ici la partie s'est arrêtée faute de tours, ou parce que son résultat était acquis. Le joueur qui a le plus de points gagne.
+            if (game.decided)
+                cout << "Résultat acquis à " << game.compteTour << ((game.compteTour != 1) ? (" tours de la fin.") : (" tour de la fin.")) << endl;
+            if (game.VScore [0] > game.VScore [1]){
+                ShowColoredName (VPair [0]);
+                cout << " gagne grâce à ses " << game.VScore [0] << " points." << endl;
+            }
+            else if (game.VScore [0] < game.VScore [1]){
+                ShowColoredName (VPair [1]);
+                cout << " gagne grâce à ses " << game.VScore [1] << " points." << endl;
+            }
+            else
+                cout << "Match nul !" << endl;
+        }
+        else if (game.timeForfeit){
+            ShowColoredName (VPair [2 - game.winner]);
+            cout << "n'a plus de temps : ";
+            ShowColoredName (VPair [game.winner - 1]);
+            cout << "gagne." << endl;
+        }
+        else if (game.winner == 1){
+            ShowColoredName (VPair [0]);
+            cout << "gagne en " << game.cptJ1 << " tours avec " << game.VScore [0] << " points." << endl;
+        }
+        else {
+            ShowColoredName (VPair [1]);
+            cout << "gagne en " << game.cptJ2 << " tours avec " << game.VScore [1] << " points." << endl;
+        }
+        FinishMatchTelemetry (matchTelemetry, VPair [0].first + " vs " + VPair [1].first);
+
+        //! La graine et les coups suffisent à rejouer la partie avec --replay.
+        cout << "Graine de la partie : " << game.seed << " (" << game.VMove.size () << " coups : " << string (game.VMove.begin (), game.VMove.end ()) << ")" << endl;
+
+        //! 738. Attente avant la partie ou l'écran suivant.
+        Pause (config.hasHuman);
+        return MatchResult (game, VPair [0].first, VPair [1].first);
+    } // PlayMatch ()
+
+    /*!
+     * \fn CMatchResult PlayComputerMatch (const CVPairStr & VPair, const TPlayerKind VPairKind [2], const CMatchConfig & config, const uint64_t & seed, const unsigned & nbMctsThreads)
+     * \brief Joue sans affichage une partie entre deux joueurs ordinateur. Plusieurs de ces parties peuvent tourner en même temps.
+     * \param nbMctsThreads threads de chaque joueur Monte-Carlo, pour ne pas surcharger les coeurs quand les parties sont simultanées.
+     */
+    CMatchResult PlayComputerMatch (const CVPairStr & VPair, const TPlayerKind VPairKind [2], const CMatchConfig & config, const uint64_t & seed, const unsigned & nbMctsThreads){
+        CGameState game;
+        game.telemetry = SharedTelemetry ();
+        game.earlyEnd  = true;
+        InitGame (game, config.matrixSize, seed);
+
+        CSearchBot VBot [2];
+        CMctsBot   VMcts [2];
+        InitComputers (VBot, VMcts, VPairKind, config.botMs, nbMctsThreads);
+        while (!IsOver (game))
+            Step (game, (VPairKind [game.turn - 1] == KComputerSearch) ? SearchMove (VBot [game.turn - 1], game) : MctsMove (VMcts [game.turn - 1], game));
+        return MatchResult (game, VPair [0].first, VPair [1].first);
+    } // PlayComputerMatch ()
+
+    //! Les deux joueurs d'une partie de tournoi, repérés par leur indice dans VNameColor.
+    typedef pair <unsigned, unsigned> CPairing;
+    //! Adversaire d'un joueur exempté pour la ronde.
+    const unsigned KBye = UINT_MAX;
+
+    /*!
+     * \struct CTournament
+     * \brief État d'un tournoi entre les joueurs de VNameColor, repérés par leur indice : tout ce qu'il faut pour construire la ronde suivante.
+     */
+    struct CTournament {
+        TTournament              format;
+        //! Rondes déjà jouées, et nombre de rondes prévu pour le système suisse (ceil (log2 (nombre de joueurs))).
+        unsigned                 round;
+        unsigned                 nbRounds;
+        //! Points de chaque joueur : 2 par victoire ou exemption, 1 par match nul.
+        vector<unsigned>         VPoints;
+        //! Pièces ramassées par chaque joueur depuis le début du tournoi : elles départagent les égalités.
+        vector<unsigned>         VScore;
+        //! Joueurs encore en lice, dans l'ordre du tableau (élimination directe).
+        vector<unsigned>         VAlive;
+        //! Le joueur a déjà été exempté d'une ronde.
+        vector<bool>             VBye;
+        //! Adversaires déjà rencontrés par chaque joueur.
+        vector<vector<unsigned>> VOpponents;
+    };
+
+    //! Aucune partie affichée en cours (CSession::liveMatch).
+    const uint32_t KNoMatch = UINT32_MAX;
+
+    /*!
+     * \struct CSession
+     * \brief Série de parties lancée depuis le menu : joueurs, réglages, tournoi et parties jouées. C'est ce qu'enregistre un point de reprise.
+     * Pendant une ronde, VRoundDone indique les parties déjà terminées ; la partie affichée en cours est liveMatch, avec ses coups dans live.
+     */
+    struct CSession {
+        unsigned              mode;
+        TTournament           format;
+        //! Pions des joueurs 1 et 2 (TokenPlayer1, TokenPlayer2).
+        char                  tokens [2];
+        uint64_t              baseSeed;
+        CMatchConfig          config;
+        //! Tours entre deux points de reprise de la partie affichée (--checkpoint).
+        uint32_t              checkpointTurns;
+        CVPairStr             VNameColor;
+        vector<TPlayerKind>   VKind;
+        CTournament           tour;
+        //! Parties des rondes déjà prises en compte, pour les graines MatchSeed (baseSeed, numéro).
+        uint64_t              nbMatches;
+        //! Parties terminées, pour la sauvegarde.
+        vector<CMatchResult>  VResult;
+        //! Ronde en cours (vides entre deux rondes).
+        vector<CMatchResult>  VRoundResult;
+        vector<uint8_t>       VRoundDone;
+        uint32_t              liveMatch;
+        CMatchProgress        live;
+    };
+
+    /*!
+     * \fn void InitTournament (CTournament & tour, const TTournament & format, const unsigned & nbPlayers)
+     * \brief Prépare un tournoi : personne n'a joué, tous les joueurs sont en lice dans l'ordre de leur inscription.
+     */
+    void InitTournament (CTournament & tour, const TTournament & format, const unsigned & nbPlayers){
+        tour.format   = format;
+        tour.round    = 0;
+        tour.nbRounds = 0;
+        while ((1u << tour.nbRounds) < nbPlayers) ++tour.nbRounds;
+        tour.VPoints.assign (nbPlayers, 0);
+        tour.VScore.assign (nbPlayers, 0);
+        tour.VAlive.resize (nbPlayers);
+        for (unsigned i(0); i < nbPlayers; ++i)
+            tour.VAlive [i] = i;
+        tour.VBye.assign (nbPlayers, false);
+        tour.VOpponents.assign (nbPlayers, vector<unsigned> ());
+    } // InitTournament ()
+
+    /*!
+     * \fn bool TournamentOver (const CTournament & tour)
+     * \brief Élimination directe : il ne reste qu'un joueur. Système suisse : toutes les rondes prévues ont été jouées.
+     */
+    bool TournamentOver (const CTournament & tour){
+        return (tour.format == KKnockout) ? tour.VAlive.size () <= 1 : tour.round >= tour.nbRounds;
+    } // TournamentOver ()
+
+    /*!
+     * \fn bool RankedBefore (const CTournament & tour, const unsigned & a, const unsigned & b)
+     * \brief Ordre du classement : plus de points, puis plus de pièces (VScore), puis ordre d'inscription.
+     */
+    bool RankedBefore (const CTournament & tour, const unsigned & a, const unsigned & b){
+        if (tour.VPoints [a] != tour.VPoints [b]) return tour.VPoints [a] > tour.VPoints [b];
+        if (tour.VScore  [a] != tour.VScore  [b]) return tour.VScore  [a] > tour.VScore  [b];
+        return a < b;
+    } // RankedBefore ()
+
+    /*!
+     * \fn vector<unsigned> Standings (const CTournament & tour)
+     * \brief Indices de tous les joueurs, du premier au dernier du classement.
+     */
+    vector<unsigned> Standings (const CTournament & tour){
+        vector<unsigned> VRank (tour.VPoints.size ());
+        for (unsigned i(0); i < VRank.size (); ++i)
+            VRank [i] = i;
+        sort (VRank.begin (), VRank.end (), [&tour] (const unsigned & a, const unsigned & b){ return RankedBefore (tour, a, b); });
+        return VRank;
+    } // Standings ()
+
+    /*!
+     * \fn vector<CPairing> PairRound (const CTournament & tour)
+     * \brief Couples (joueur 1, joueur 2) de la ronde suivante. Un joueur exempté est associé à KBye.
+     * Dans les deux formats, s'ils sont en nombre impair, le moins bien classé des joueurs jamais exemptés l'est.
+     * Élimination directe : les autres joueurs en lice se rencontrent deux à deux dans l'ordre du tableau.
+     * Système suisse : dans l'ordre du classement, chacun rencontre le suivant qu'il n'a pas encore affronté (à défaut, le suivant).
+     */
+    vector<CPairing> PairRound (const CTournament & tour){
+        vector<CPairing> VPairing;
+        if (tour.format == KKnockout){
+            vector<unsigned> VBracket (tour.VAlive);
+            unsigned bye (KBye);
+            if (VBracket.size () % 2 != 0){
+                //! Le moins bien classé des joueurs en lice jamais exemptés, à défaut le moins bien classé.
+                for (const unsigned & player : VBracket)
+                    if (bye == KBye || (tour.VBye [bye] && !tour.VBye [player])
+                                    || (tour.VBye [bye] == tour.VBye [player] && RankedBefore (tour, bye, player)))
+                        bye = player;
+                VBracket.erase (find (VBracket.begin (), VBracket.end (), bye));
+            }
+            for (unsigned i(0); i + 1 < VBracket.size (); i += 2)
+                VPairing.push_back (CPairing (VBracket [i], VBracket [i + 1]));
+            if (bye != KBye)
+                VPairing.push_back (CPairing (bye, KBye));
+            return VPairing;
+        }
+
+        vector<unsigned> VRank (Standings (tour));
+        if (VRank.size () % 2 != 0){
+            unsigned bye (VRank.size () - 1);
+            for (unsigned i (VRank.size ()); i-- > 0;)
+                if (!tour.VBye [VRank [i]]){
+                    bye = i;
+                    break;
+                }
+            VPairing.push_back (CPairing (VRank [bye], KBye));
+            VRank.erase (VRank.begin () + bye);
+        }
+        vector<bool> VPaired (VRank.size (), false);
+        for (unsigned i(0); i < VRank.size (); ++i){
+            if (VPaired [i]) continue;
+            const vector<unsigned> & VMet (tour.VOpponents [VRank [i]]);
+            unsigned opponent (VRank.size ());
+            for (unsigned j (i + 1); j < VRank.size (); ++j){
+                if (VPaired [j]) continue;
+                if (opponent == VRank.size ()) opponent = j;
+                if (find (VMet.begin (), VMet.end (), VRank [j]) == VMet.end ()){
+                    opponent = j;
+                    break;
+                }
+            }
+            VPaired [i] = VPaired [opponent] = true;
+            VPairing.push_back (CPairing (VRank [i], VRank [opponent]));
+        }
+        //! L'exemption est annoncée après les parties.
+        if (!VPairing.empty () && VPairing.front ().second == KBye)
+            rotate (VPairing.begin (), VPairing.begin () + 1, VPairing.end ());
+        return VPairing;
+    } // PairRound ()
+
+    /*!
+     * \fn void RecordRound (CTournament & tour, const vector<CPairing> & VPairing, const vector<CMatchResult> & VRoundResult)
+     * \brief Prend en compte les résultats de la ronde : points, pièces, adversaires rencontrés et, en élimination directe, joueurs qualifiés.
+     * Un match nul en élimination directe est départagé par les pièces ramassées depuis le début du tournoi, puis par l'ordre d'inscription.
+     */
+    void RecordRound (CTournament & tour, const vector<CPairing> & VPairing, const vector<CMatchResult> & VRoundResult){
+        vector<unsigned> VQualified;
+        for (unsigned k(0); k < VPairing.size (); ++k){
+            const unsigned player1 (VPairing [k].first);
+            const unsigned player2 (VPairing [k].second);
+            if (player2 == KBye){
+                tour.VPoints [player1] += 2;
+                tour.VBye [player1] = true;
+                VQualified.push_back (player1);
+                continue;
+            }
+            const CMatchResult & result (VRoundResult [k]);
+            tour.VScore [player1] += result.VScore [0];
+            tour.VScore [player2] += result.VScore [1];
+            tour.VOpponents [player1].push_back (player2);
+            tour.VOpponents [player2].push_back (player1);
+            if (result.winner == 0){
+                ++tour.VPoints [player1];
+                ++tour.VPoints [player2];
+            }
+            else
+                tour.VPoints [(result.winner == 1) ? player1 : player2] += 2;
+
+            if (result.winner != 0)
+                VQualified.push_back ((result.winner == 1) ? player1 : player2);
+            else if (tour.VScore [player1] != tour.VScore [player2])
+                VQualified.push_back ((tour.VScore [player1] > tour.VScore [player2]) ? player1 : player2);
+            else
+                VQualified.push_back (min (player1, player2));
+        }
+        //! Les qualifiés restent dans l'ordre du tableau, l'exempté à la fin.
+        if (tour.format == KKnockout)
+            tour.VAlive = VQualified;
+        ++tour.round;
+    } // RecordRound ()
+
+    /*!
+     * \fn void PlayRound (CSession & session, const vector<CPairing> & VPairing, CTelemetry & matchTelemetry)
+     * \brief Joue les parties de la ronde qui ne sont pas encore terminées (session.VRoundDone) et range leurs résultats dans session.VRoundResult.
+     * Celles entre joueurs ordinateur tournent en même temps, sans affichage, sur tous les coeurs ; celles où joue un humain sont ensuite affichées l'une après l'autre.
+     * La partie k de la ronde a la graine MatchSeed (baseSeed, nbMatches + k). Chaque partie terminée donne un point de reprise.
+     */
+    void PlayRound (CSession & session, const vector<CPairing> & VPairing, CTelemetry & matchTelemetry){
+        const CVPairStr &           VNameColor (session.VNameColor);
+        const vector<TPlayerKind> & VKind (session.VKind);
+        const CMatchConfig &        config (session.config);
+        vector<unsigned> VComputer, VHuman;
+        for (unsigned k(0); k < VPairing.size (); ++k){
+            if (VPairing [k].second == KBye || session.VRoundDone [k]) continue;
+            if (VKind [VPairing [k].first] != KHuman && VKind [VPairing [k].second] != KHuman)
+                VComputer.push_back (k);
+            else
+                VHuman.push_back (k);
+        }
+
+        const unsigned nbCores (max (thread::hardware_concurrency (), 1u));
+        const unsigned nbThreads (max (min (nbCores, unsigned (VComputer.size ())), 1u));
+        if (!VComputer.empty ()){
+            cout << "Calcul de " << VComputer.size () << " partie(s) entre ordinateurs sur " << nbThreads << " coeur(s)..." << endl;
+            RunParallel (VComputer.size (), nbThreads, [&] (unsigned task, unsigned){
+                const unsigned k (VComputer [task]);
+                const CVPairStr VPair = {VNameColor [VPairing [k].first], VNameColor [VPairing [k].second]};
+                const TPlayerKind VPairKind [2] = {VKind [VPairing [k].first], VKind [VPairing [k].second]};
+                const CMatchResult result (PlayComputerMatch (VPair, VPairKind, config, MatchSeed (session.baseSeed, session.nbMatches + k), max (nbCores / nbThreads, 1u)));
+                //! Chaque partie écrit dans sa propre case ; le verrou empêche seulement d'encoder un point de reprise pendant l'écriture.
+                {
+                    lock_guard<mutex> guard (Checkpointer.sessionLock);
+                    session.VRoundResult [k] = result;
+                    session.VRoundDone [k]   = 1;
+                }
+                SaveCheckpoint ();
+            });
+        }
+        for (const unsigned & k : VHuman){
+            const CVPairStr VPair = {VNameColor [VPairing [k].first], VNameColor [VPairing [k].second]};
+            const TPlayerKind VPairKind [2] = {VKind [VPairing [k].first], VKind [VPairing [k].second]};
+            //! Une partie reprise garde ses coups ; une autre commence sans coup.
+            if (session.liveMatch != k){
+                session.liveMatch = k;
+                session.live.VMove.clear ();
+            }
+            session.VRoundResult [k] = PlayMatch (VPair, VPairKind, config, MatchSeed (session.baseSeed, session.nbMatches + k), matchTelemetry, session.live);
+            session.VRoundDone [k]   = 1;
+            session.liveMatch        = KNoMatch;
+            SaveCheckpoint ();
+        }
+    } // PlayRound ()
+
+    /*!
+     * \fn void ShowRound (const CTournament & tour, CVPairStr VNameColor, const vector<CPairing> & VPairing, const vector<CMatchResult> & VRoundResult)
+     * \brief Affiche les résultats de la ronde qui vient d'être prise en compte.
+     */
+    void ShowRound (const CTournament & tour, CVPairStr VNameColor, const vector<CPairing> & VPairing, const vector<CMatchResult> & VRoundResult){
+        ClearScreen ();
+        Couleur (KBleu);
+        cout << "Ronde " << tour.round;
+        if (tour.format == KSwiss) cout << " / " << tour.nbRounds;
+        cout << endl << endl;
+        Couleur (KReset);
+        for (unsigned k(0); k < VPairing.size (); ++k){
+            ShowColoredName (VNameColor [VPairing [k].first]);
+            if (VPairing [k].second == KBye){
+                cout << ": exempté" << endl;
+                continue;
+            }
+            const CMatchResult & result (VRoundResult [k]);
+            cout << result.VScore [0] << " - " << result.VScore [1] << " ";
+            ShowColoredName (VNameColor [VPairing [k].second]);
+            cout << ": " << ((result.winner == 0) ? string ("match nul") : VNameColor [(result.winner == 1) ? VPairing [k].first : VPairing [k].second].first + " gagne");
+            //! En élimination directe, le départage d'un match nul désigne le qualifié.
+            if (result.winner == 0 && tour.format == KKnockout)
+                cout << ", " << VNameColor [(find (tour.VAlive.begin (), tour.VAlive.end (), VPairing [k].first) != tour.VAlive.end ()) ? VPairing [k].first : VPairing [k].second].first << " qualifié aux pièces";
+            cout << endl;
+        }
+        if (tour.format == KKnockout && !TournamentOver (tour))
+            cout << endl << tour.VAlive.size () << " joueurs encore en lice." << endl;
+    } // ShowRound ()
+
+    //! Case sans joueur dans l'index d'occupation de la mêlée.
+    const uint32_t KNoOccupant = UINT32_MAX;
+
+    /*!
+     * \struct COccupancy
+     * \brief Index d'occupation de la mêlée : joueur présent sur chaque case (i * side + j), KNoOccupant si aucun. Lecture et écriture en temps constant.
+     * Comme pour CFreeCells, un tableau sur les grilles jusqu'à KDenseLimit cases, au-delà une table de hachage des seules cases occupées.
+     */
+    struct COccupancy {
+        static const size_t KDenseLimit = size_t (1) << 22;
+
+        bool                              dense = true;
+        vector<uint32_t>                  cells;
+        unordered_map<size_t, uint32_t>   sparse;
+
+        void Reset (const size_t & nbCells){
+            dense = nbCells <= KDenseLimit;
+            sparse.clear ();
+            if (dense)
+                cells.assign (nbCells, KNoOccupant);
+            else
+                cells.clear ();
+        }
+        uint32_t At (const size_t & cell) const {
+            if (dense) return cells [cell];
+            unordered_map<size_t, uint32_t>::const_iterator it (sparse.find (cell));
+            return it == sparse.end () ? KNoOccupant : it->second;
+        }
+        void Set (const size_t & cell, const uint32_t & player){
+            if (dense)
+                cells [cell] = player;
+            else
+                sparse [cell] = player;
+        }
+        void Clear (const size_t & cell){
+            if (dense)
+                cells [cell] = KNoOccupant;
+            else
+                sparse.erase (cell);
+        }
+    };
+
+    /*!
+     * \struct CMeleePlayer
+     * \brief Un joueur de la mêlée : position, pièces, captures et pion affiché (première lettre de son nom).
+     */
+    struct CMeleePlayer {
+        CPosition pos;
+        unsigned  score;
+        unsigned  captures;
+        bool      alive;
+        char      token;
+        //! Joueurs en lice précédent et suivant dans l'ordre du jeu : les joueurs en lice forment un anneau, dont les joueurs éliminés sont retirés.
+        //! Un joueur éliminé garde son suivant, pour que le trait passe au bon joueur s'il est éliminé pendant son coup.
+        unsigned  prev;
+        unsigned  next;
+    };
+
+    /*!
+     * \struct CMeleeState
+     * \brief État d'une mêlée : tous les joueurs de VNameColor sur une même grille, chacun à son tour dans l'ordre de VNameColor.
+     * Un joueur qui arrive sur un autre le capture : le joueur capturé est éliminé et ses pièces passent à celui qui l'a capturé.
+     * La partie se termine quand il ne reste qu'un joueur, quand un joueur atteint le carré rouge, ou à la fin des tours (le joueur en lice qui a le plus de pièces gagne).
+     */
+    struct CMeleeState {
+        CMatrix              mat;
+        unsigned             matrixSize;
+        vector<CMeleePlayer> VPlayer;
+        //! Joueur présent sur chaque case : une capture se teste en un accès, quel que soit le nombre de joueurs.
+        COccupancy           occupancy;
+        unsigned             nbAlive;
+        //! Joueur qui a le trait (indice dans VPlayer).
+        unsigned             current;
+        //! Nombre de tours restants : un tour est compté quand tous les joueurs en lice ont joué.
+        unsigned             compteTour;
+        //! 0 tant que personne n'a gagné par capture du dernier adversaire ou par le carré rouge, sinon indice du vainqueur + 1.
+        unsigned             winner;
+        CPosition            posRedSquare;
+        bool                 doesRedSquare;
+        CCoinStore           VPosCoin;
+        CBitPlane            coinPlane;
+        CFreeCells           freeCells;
+        unsigned             chance;
+        uint64_t             seed;
+        CRng                 rng;
+        uint64_t             nbMoves;
+    };
+
+    /*!
+     * \fn void SpawnMeleeTokens (CMeleeState & melee)
+     * \brief Fait apparaitre aléatoirement les pions spéciaux avant le coup du joueur qui a le trait, comme SpawnTokens ().
+     */
+    void SpawnMeleeTokens (CMeleeState & melee){
+        if (melee.doesRedSquare)
+            MakeRedSquareAppear (melee.rng, melee.mat, KTokenRedSquare, melee.doesRedSquare, melee.posRedSquare, melee.chance, melee.freeCells);
+        MakeCoinAppear (melee.rng, melee.mat, melee.VPosCoin, melee.coinPlane, melee.chance, melee.freeCells);
+    } // SpawnMeleeTokens ()
+
+    /*!
+     * \fn void InitMelee (CMeleeState & melee, const unsigned & matrixSize, const CVPairStr & VNameColor, const uint64_t & seed)
+     * \brief Prépare une mêlée : un joueur par entrée de VNameColor, placés sur des cases tirées au hasard (la grille doit avoir plus de cases que de joueurs,
+     * sinon length_error est levée).
+     */
+    void InitMelee (CMeleeState & melee, const unsigned & matrixSize, const CVPairStr & VNameColor, const uint64_t & seed){
+        melee.matrixSize = matrixSize;
+        melee.seed       = seed;
+        melee.rng.Seed (seed);
+        InitMat (melee.mat, matrixSize);
+        const size_t nbCells (size_t (matrixSize) * matrixSize);
+        melee.occupancy.Reset (nbCells);
+        melee.freeCells.Reset (nbCells);
+        melee.coinPlane.Reset (nbCells);
+        melee.VPosCoin.cells.clear ();
+        melee.VPosCoin.slot.clear ();
+        melee.VPosCoin.VBlock.clear ();
+
+        melee.VPlayer.assign (VNameColor.size (), CMeleePlayer ());
+        for (unsigned i(0); i < VNameColor.size (); ++i){
+            CMeleePlayer & player (melee.VPlayer [i]);
+            const size_t cell (GeneratePosition (melee.rng, melee.freeCells));
+            if (cell == KNoCell) throw length_error ("InitMelee : plus de joueurs que de cases");
+            player.pos      = CellPosition (cell, matrixSize);
+            player.score    = player.captures = 0;
+            player.alive    = true;
+            player.prev     = (i + VNameColor.size () - 1) % VNameColor.size ();
+            player.next     = (i + 1) % VNameColor.size ();
+            //! Les pions spéciaux gardent leur signe : un nom qui commence par l'un d'eux est affiché '@'.
+            const char first (VNameColor [i].first.empty () ? '@' : VNameColor [i].first [0]);
+            player.token    = (first == KEmpty || first == KTokenRedSquare || first == KTokenCoin) ? '@' : first;
+            melee.occupancy.Set (cell, i);
+            melee.freeCells.Remove (cell);
+            melee.mat.cells [cell] = player.token;
+        }
+        melee.nbAlive       = VNameColor.size ();
+        melee.current       = 0;
+        melee.compteTour    = matrixSize * 1.5;
+        melee.winner        = 0;
+        melee.posRedSquare  = CPosition ();
+        melee.doesRedSquare = true;
+        melee.chance        = 30;
+        melee.nbMoves       = 0;
+
+        SpawnMeleeTokens (melee);
+    } // InitMelee ()
+
+    /*!
+     * \fn bool IsMeleeOver (const CMeleeState & melee)
+     * \brief Indique si la mêlée est terminée.
+     */
+    bool IsMeleeOver (const CMeleeState & melee){
+        return melee.winner != 0 || melee.compteTour == 0;
+    } // IsMeleeOver ()
+
+    /*!
+     * \fn void NextMeleePlayer (CMeleeState & melee)
+     * \brief Donne le trait au joueur en lice suivant et décompte le tour quand tous ont joué. L'anneau des joueurs en lice ne contient
+     * pas les joueurs éliminés : O(1) par coup, quel que soit le nombre de joueurs éliminés.
+     */
+    void NextMeleePlayer (CMeleeState & melee){
+        const unsigned next (melee.VPlayer [melee.current].next);
+        //! Revenir à un joueur inscrit plus tôt, c'est commencer un nouveau tour.
+        if (next <= melee.current) --melee.compteTour;
+        melee.current = next;
+    } // NextMeleePlayer ()
+
+    /*!
+     * \fn void EliminateMeleePlayer (CMeleeState & melee, const unsigned & player)
+     * \brief Retire de la grille un joueur capturé ou qui n'a plus de temps. Le dernier joueur en lice gagne.
+     */
+    void EliminateMeleePlayer (CMeleeState & melee, const unsigned & player){
+        CMeleePlayer & eliminated (melee.VPlayer [player]);
+        eliminated.alive = false;
+        melee.VPlayer [eliminated.prev].next = eliminated.next;
+        melee.VPlayer [eliminated.next].prev = eliminated.prev;
+        //! Il ne reste dans l'anneau que le suivant du joueur éliminé.
+        if (--melee.nbAlive == 1 && melee.winner == 0)
+            melee.winner = eliminated.next + 1;
+    } // EliminateMeleePlayer ()
+
+    /*!
+     * \fn TStepStatus MeleeStep (CMeleeState & melee, const char & move)
+     * \brief Joue le coup du joueur qui a le trait et applique les règles de la mêlée. Si le coup est refusé, l'état n'est pas modifié.
+     * Chaque coup coûte O(1) quel que soit le nombre de joueurs : la capture est lue dans l'index d'occupation.
+     */
+    TStepStatus MeleeStep (CMeleeState & melee, const char & move){
+        if (IsMeleeOver (melee)) return KStepGameOver;
+        CMeleePlayer & player (melee.VPlayer [melee.current]);
+        const TStepStatus status (CheckMove (move, player.pos, melee.matrixSize));
+        if (status != KStepOk) return status;
+
+        const size_t from (melee.mat.Index (player.pos.first, player.pos.second));
+        melee.occupancy.Clear (from);
+        melee.freeCells.Insert (from);
+        melee.mat.cells [from] = KEmpty;
+        player.pos = Destination (move, player.pos);
+        const size_t cell (melee.mat.Index (player.pos.first, player.pos.second));
+        ++melee.nbMoves;
+
+        //! Le joueur capturé est éliminé, ses pièces passent à celui qui l'a capturé.
+        const uint32_t victim (melee.occupancy.At (cell));
+        if (victim != KNoOccupant){
+            ++player.captures;
+            player.score += melee.VPlayer [victim].score;
+            EliminateMeleePlayer (melee, victim);
+        }
+        if (!melee.doesRedSquare && player.pos == melee.posRedSquare)
+            melee.winner = melee.current + 1;
+        if (melee.coinPlane.Test (cell) && RemoveCoin (melee.VPosCoin, melee.coinPlane, melee.mat, cell))
+            ++player.score;
+        melee.occupancy.Set (cell, melee.current);
+        melee.freeCells.Remove (cell);
+        melee.mat.cells [cell] = player.token;
+
+        if (melee.winner != 0) return KStepOk;
+        NextMeleePlayer (melee);
+        if (!IsMeleeOver (melee))
+            SpawnMeleeTokens (melee);
+        return KStepOk;
+    } // MeleeStep ()
+
+    /*!
+     * \fn void MeleeForfeit (CMeleeState & melee)
+     * \brief Le joueur qui a le trait n'a plus de temps : il est éliminé et quitte la grille.
+     */
+    void MeleeForfeit (CMeleeState & melee){
+        if (IsMeleeOver (melee)) return;
+        const unsigned player (melee.current);
+        const size_t   cell (melee.mat.Index (melee.VPlayer [player].pos.first, melee.VPlayer [player].pos.second));
+        melee.occupancy.Clear (cell);
+        melee.freeCells.Insert (cell);
+        melee.mat.cells [cell] = KEmpty;
+        EliminateMeleePlayer (melee, player);
+        if (melee.winner == 0) NextMeleePlayer (melee);
+    } // MeleeForfeit ()
+
+    /*!
+     * \fn unsigned MeleeLeader (const CMeleeState & melee)
+     * \brief Vainqueur de la mêlée terminée (indice + 1) : par capture ou carré rouge, sinon le joueur en lice qui a le plus de pièces. 0 en cas d'égalité.
+     */
+    unsigned MeleeLeader (const CMeleeState & melee){
+        if (melee.winner != 0) return melee.winner;
+        unsigned leader (0), best (0);
+        for (unsigned i(0); i < melee.VPlayer.size (); ++i){
+            const CMeleePlayer & player (melee.VPlayer [i]);
+            if (!player.alive) continue;
+            if (leader == 0 || player.score > best){
+                leader = i + 1;
+                best   = player.score;
+            }
+            else if (player.score == best)
+                leader = UINT_MAX;
+        }
+        return leader == UINT_MAX ? 0 : leader;
+    } // MeleeLeader ()
+
+    /*!
+     * \fn vector<unsigned> MeleeStandings (const CMeleeState & melee)
+     * \brief Classement de la mêlée : vainqueur, joueurs en lice, puis pièces et captures.
+     */
+    vector<unsigned> MeleeStandings (const CMeleeState & melee){
+        vector<unsigned> VRank (melee.VPlayer.size ());
+        for (unsigned i(0); i < VRank.size (); ++i)
+            VRank [i] = i;
+        const unsigned winner (MeleeLeader (melee));
+        stable_sort (VRank.begin (), VRank.end (), [&] (const unsigned & a, const unsigned & b){
+            const CMeleePlayer & pa (melee.VPlayer [a]), & pb (melee.VPlayer [b]);
+            if ((a + 1 == winner) != (b + 1 == winner)) return a + 1 == winner;
+            if (pa.alive != pb.alive) return pa.alive;
+            if (pa.score != pb.score) return pa.score > pb.score;
+            return pa.captures > pb.captures;
+        });
+        return VRank;
+    } // MeleeStandings ()
+
+    /*!
+     * \fn char MeleeBotMove (const CMeleeState & melee, CRng & botRng)
+     * \brief Coup d'un joueur ordinateur de la mêlée, à la manière de BotMove () : capture ou carré rouge si possible, sinon une pièce,
+     * en évitant de finir à côté d'un adversaire. Les huit voisins de chaque destination sont lus dans l'index d'occupation : O(1) par coup.
+     */
+    char MeleeBotMove (const CMeleeState & melee, CRng & botRng){
+        const CPosition & pos (melee.VPlayer [melee.current].pos);
+        const unsigned legal (LegalMoves (pos, melee.matrixSize));
+        char best (KMoveKeys [0]);
+        int  bestScore (INT_MIN);
+        for (unsigned k(0); k < 8; ++k){
+            if (!(legal & (1u << k))) continue;
+            const CPosition dest (Destination (KMoveKeys [k], pos));
+            const size_t    cell (melee.mat.Index (dest.first, dest.second));
+
+            int score (RandomBelow (botRng, 8));
+            if (melee.occupancy.At (cell) != KNoOccupant)
+                score += 10000;
+            else if (!melee.doesRedSquare && dest == melee.posRedSquare)
+                score += 9000;
+            else {
+                if (melee.coinPlane.Test (cell)) score += 50;
+                //! Une case voisine d'un adversaire lui offre la capture avant notre prochain coup.
+                const unsigned around (LegalMoves (dest, melee.matrixSize));
+                for (unsigned n(0); n < 8; ++n){
+                    if (!(around & (1u << n))) continue;
+                    const CPosition next (Destination (KMoveKeys [n], dest));
+                    if (next != pos && melee.occupancy.At (melee.mat.Index (next.first, next.second)) != KNoOccupant){
+                        score -= 5000;
+                        break;
+                    }
+                }
+            }
+            if (score > bestScore){
+                bestScore = score;
+                best = KMoveKeys [k];
+            }
+        }
+        return best;
+    } // MeleeBotMove ()
+
+    /*!
+     * \fn void ComposeMelee (CFrame & frame, CMeleeState & melee, const CVPairStr & VNameColor, const vector<unsigned char> & VColor, const unsigned & termRows, const unsigned & termCols)
+     * \brief Construit l'image de la mêlée, dans la mise en page de ComposeMatrix () : fenêtre centrée sur le joueur qui a le trait et minicarte des joueurs en lice.
+     * Les cases de la fenêtre sont lues dans l'index d'occupation : le coût de l'image dépend de la fenêtre, pas du nombre de joueurs, sauf pour la minicarte.
+     * melee n'est modifié que par les compteurs de pièces de la minicarte (CountCoinBlocks ()).
+     * \param VColor couleur de chaque joueur, tirée de VNameColor.
+     */
+    void ComposeMelee (CFrame & frame, CMeleeState & melee, const CVPairStr & VNameColor, const vector<unsigned char> & VColor, const unsigned & termRows, const unsigned & termCols){
+        const CMatrix & mat (melee.mat);
+        const unsigned  current (melee.current);
+        const unsigned char colorRouge (stoi (KRouge));
+        const unsigned char colorBleu  (stoi (KBleu));
+        const CViewport view (FitViewport (mat.side, melee.VPlayer [current].pos, termRows, termCols));
+
+        frame.assign (1, CFrameLine ());
+        ComposeMoveHelp (frame);
+        FramePut (frame, "\n\tMêlée : " + to_string (melee.nbAlive) + " joueurs en lice sur " + to_string (melee.VPlayer.size ()), KReset);
+        FramePut (frame, "\nScore : ", KBleu);
+        FramePut (frame, VNameColor [current].first, VNameColor [current].second);
+        FramePut (frame, " " + to_string (melee.VPlayer [current].score) + " pièces, " + to_string (melee.VPlayer [current].captures) + " captures", KReset);
+        if (view.nbRows == mat.side && view.nbCols == mat.side)
+            FramePut (frame, "\n\n\n", KReset);
+        else
+            FramePut (frame, "\nLignes " + to_string (view.top + 1) + " à " + to_string (view.top + view.nbRows) + ", colonnes " + to_string (view.left + 1) + " à " + to_string (view.left + view.nbCols) + " sur " + to_string (mat.side) + "\n\n", KReset);
+
+        vector<CCell> VMap;
+        if (view.mapRows){
+            InitMinimap (VMap, mat.side, view);
+            MarkCoinBlocks (VMap, melee.VPosCoin, mat.side, view, colorBleu);
+            if (!melee.doesRedSquare)
+                MarkMinimap (VMap, mat.side, view, melee.posRedSquare, KTokenRedSquare, colorRouge);
+            for (unsigned i(0); i < melee.VPlayer.size (); ++i)
+                if (melee.VPlayer [i].alive)
+                    MarkMinimap (VMap, mat.side, view, melee.VPlayer [i].pos, melee.VPlayer [i].token, VColor [i]);
+            //! Le joueur qui a le trait reste visible même si son bloc contient d'autres joueurs.
+            MarkMinimap (VMap, mat.side, view, melee.VPlayer [current].pos, melee.VPlayer [current].token, VColor [current]);
+        }
+        for (unsigned i (view.top); i < view.top + view.nbRows; ++i){
+            CFrameLine & line (frame.back ());
+            const char * row (mat.Row (i));
+            line.reserve (2 * view.nbCols + 1 + (view.mapRows ? view.mapCols + 4 : 0));
+            FramePutCell (line, '|', 0);
+            for (unsigned j (view.left); j < view.left + view.nbCols; ++j){
+                const uint32_t occupant (melee.occupancy.At (mat.Index (i, j)));
+                if (occupant != KNoOccupant)
+                    FramePutCell (line, row[j], VColor [occupant]);
+                else if (row[j] == KTokenRedSquare)
+                    FramePutCell (line, KTokenRedSquare, colorRouge);
+                else if (row[j] == KTokenCoin)
+                    FramePutCell (line, KTokenCoin, colorBleu);
+                else
+                    FramePutCell (line, KEmpty, 0);
+                FramePutCell (line, '|', 0);
+            }
+            ComposeMinimapLine (line, VMap, view, i - view.top);
+            frame.push_back (CFrameLine ());
+        }
+        FramePut (frame, "\n\n", KReset);
+
+        FramePut (frame, to_string (melee.compteTour), KBleu);
+        FramePut (frame, ((melee.compteTour != 1) ? (" tours restants\n") : (" tour restant\n")), KReset);
+        FramePut (frame, "C'est à ", KReset);
+        FramePut (frame, VNameColor [current].first + " ", VNameColor [current].second);
+        FramePut (frame, "de jouer :\n", KReset);
+    } // ComposeMelee ()
+
+    /*!
+     * \fn void ShowMelee (CMeleeState & melee, const CVPairStr & VNameColor, const vector<unsigned char> & VColor)
+     * \brief Affiche la mêlée à l'écran, en n'envoyant que les cases modifiées comme ShowMatrix ().
+     */
+    void ShowMelee (CMeleeState & melee, const CVPairStr & VNameColor, const vector<unsigned char> & VColor){
+        static CFrame frame;
+        static string buffer;
+        static unsigned lastRows (0), lastCols (0);
+
+        unsigned termRows (0), termCols (0);
+        TerminalSize (termRows, termCols);
+        if (termRows != lastRows || termCols != lastCols) ScreenFrame.clear ();
+        lastRows = termRows;
+        lastCols = termCols;
+
+        ComposeMelee (frame, melee, VNameColor, VColor, termRows, termCols);
+        buffer.assign (ScreenFrame.empty () ? "\033[H\033[2J" : "");
+        RenderFrame (ScreenFrame, frame, buffer);
+        WriteAll (buffer);
+        ScreenFrame.swap (frame);
+    } // ShowMelee ()
+
+    /*!
+     * \fn void ShowMeleeStandings (const CMeleeState & melee, CVPairStr VNameColor, const unsigned & nbShown)
+     * \brief Affiche le résultat de la mêlée et les nbShown premiers du classement.
+     */
+    void ShowMeleeStandings (const CMeleeState & melee, CVPairStr VNameColor, const unsigned & nbShown){
+        const vector<unsigned> VRank (MeleeStandings (melee));
+        for (unsigned i(0); i < min (nbShown, unsigned (VRank.size ())); ++i){
+            const CMeleePlayer & player (melee.VPlayer [VRank [i]]);
+            cout << setw (4) << i + 1 << ". ";
+            ShowColoredName (VNameColor [VRank [i]]);
+            cout << player.score << " pièces, " << player.captures << " captures" << (player.alive ? "" : ", éliminé") << endl;
+        }
+    } // ShowMeleeStandings ()
+
+    /*!
+     * \fn unsigned PlayMelee (CVPairStr VNameColor, const vector<TPlayerKind> & VKind, const CMatchConfig & config, const uint64_t & seed, vector<unsigned> & VScore)
+     * \brief Joue à l'écran une mêlée entre tous les joueurs de VNameColor. Les joueurs ordinateur jouent MeleeBotMove ().
+     * L'écran est redessiné avant chaque coup d'un joueur humain, ou une fois par tour quand tous les joueurs sont des ordinateurs.
+     * \param VScore reçoit les pièces de chaque joueur.
+     * \return indice du vainqueur + 1, 0 en cas d'égalité.
+     */
+    unsigned PlayMelee (CVPairStr VNameColor, const vector<TPlayerKind> & VKind, const CMatchConfig & config, const uint64_t & seed, vector<unsigned> & VScore){
+        CMeleeState melee;
+        InitMelee (melee, config.matrixSize, VNameColor, seed);
+        vector<unsigned char> VColor;
+        for (const CPairString & NameColor : VNameColor)
+            VColor.push_back (ColorCode (NameColor.second));
+        //! Générateur des joueurs ordinateur, séparé de celui des apparitions pour ne pas les décaler.
+        CRng botRng;
+        botRng.Seed (seed ^ 0x5851F42D4C957F2DULL);
+        vector<long long> VClockMs (VNameColor.size (), config.clockSeconds ? (long long) config.clockSeconds * 1000 : -1);
+
+        unsigned shownTour (0);
+        char move;
+        while (!IsMeleeOver (melee)){
+            if (VKind [melee.current] != KHuman){
+                if (!config.hasHuman && melee.compteTour != shownTour){
+                    ShowMelee (melee, VNameColor, VColor);
+                    shownTour = melee.compteTour;
+                }
+                MeleeStep (melee, MeleeBotMove (melee, botRng));
+                continue;
+            }
+
+            ShowMelee (melee, VNameColor, VColor);
+            long long & clockMs (VClockMs [melee.current]);
+            TStepStatus status (KStepBadKey);
+            while (status != KStepOk && status != KStepGameOver){
+                if (!PromptMove (move, clockMs, nullptr)){
+                    MeleeForfeit (melee);
+                    break;
+                }
+                status = MeleeStep (melee, move);
+                if (status == KStepOutOfBoard || status == KStepBadKey)
+                    cout << ((status == KStepOutOfBoard) ? ("Deplacement impossible.") : ("Saisie incorrecte.")) << endl;
+            }
+        } // while ()
+
+        ClearScreen ();
+        const unsigned winner (MeleeLeader (melee));
+        if (melee.winner != 0 && melee.nbAlive > 1){
+            ShowColoredName (VNameColor [winner - 1]);
+            cout << "atteint le carré rouge et gagne la mêlée." << endl;
+        }
+        else if (melee.winner != 0){
+            ShowColoredName (VNameColor [winner - 1]);
+            cout << "est le dernier en lice et gagne la mêlée." << endl;
+        }
+        else if (winner != 0){
+            ShowColoredName (VNameColor [winner - 1]);
+            cout << "gagne grâce à ses " << melee.VPlayer [winner - 1].score << " pièces." << endl;
+        }
+        else
+            cout << "Match nul !" << endl;
+        cout << endl << "Classement de la mêlée :" << endl;
+        ShowMeleeStandings (melee, VNameColor, 10);
+        cout << "Graine de la mêlée : " << melee.seed << " (" << melee.nbMoves << " coups)" << endl;
+
+        VScore.assign (VNameColor.size (), 0);
+        for (unsigned i(0); i < VNameColor.size (); ++i)
+            VScore [i] = melee.VPlayer [i].score;
+        Pause (config.hasHuman);
+        return winner;
+    } // PlayMelee ()
+
+
+    /*!
+     * \fn int MeleeMain (int argc, char * argv [], const uint64_t & baseSeed)
+     * \brief Mêlée sans affichage entre joueurs ordinateur : --melee nbJoueurs taille. Affiche le résultat, le classement et le temps par coup.
+     */
+    int MeleeMain (int argc, char * argv [], const uint64_t & baseSeed){
+        const unsigned nbPlayers  (argc > 2 ? strtoul (argv [2], nullptr, 10) : 0);
+        const unsigned matrixSize (argc > 3 ? strtoul (argv [3], nullptr, 10) : 0);
+        if (nbPlayers < 2 || matrixSize < 2 || nbPlayers >= uint64_t (matrixSize) * matrixSize){
+            cerr << "Usage : " << argv [0] << " --melee nbJoueurs taille (au moins 2 joueurs, moins que de cases)" << endl;
+            return EXIT_FAILURE;
+        }
+        const CVPairStr VNameColor (ComputerPlayers (nbPlayers, 1));
+        CMeleeState melee;
+        const chrono::steady_clock::time_point start (chrono::steady_clock::now ());
+        InitMelee (melee, matrixSize, VNameColor, MatchSeed (baseSeed, 0));
+        CRng botRng;
+        botRng.Seed (melee.seed ^ 0x5851F42D4C957F2DULL);
+        while (!IsMeleeOver (melee))
+            MeleeStep (melee, MeleeBotMove (melee, botRng));
+        const uint64_t ns (chrono::duration_cast<chrono::nanoseconds> (chrono::steady_clock::now () - start).count ());
+
+        const unsigned winner (MeleeLeader (melee));
+        cout << "Mêlée de " << nbPlayers << " joueurs sur " << matrixSize << " x " << matrixSize << ", graine " << melee.seed << " : " << melee.nbMoves << " coups en "
+             << ns / 1000000 << " ms (" << (melee.nbMoves ? ns / melee.nbMoves : 0) << " ns par coup), " << melee.nbAlive << " joueurs en lice, vainqueur : "
+             << (winner ? VNameColor [winner - 1].first : string ("aucun")) << endl;
+        ShowMeleeStandings (melee, VNameColor, 10);
+        return 0;
+    } // MeleeMain ()
+
+    /*!
+     * \fn void PutValue (string & buffer, const T & value)
+     * \brief Ajoute les octets de value à la fin de buffer (points de reprise).
+     */
+    template <typename T>
+    void PutValue (string & buffer, const T & value){
+        buffer.append (reinterpret_cast<const char *> (&value), sizeof (value));
+    } // PutValue ()
+
+    /*!
+     * \fn void PutString (string & buffer, const string & text)
+     * \brief Ajoute la longueur de text puis ses octets à la fin de buffer.
+     */
+    void PutString (string & buffer, const string & text){
+        PutValue (buffer, uint32_t (text.size ()));
+        buffer += text;
+    } // PutString ()
+
+    /*!
+     * \struct CCheckpointReader
+     * \brief Lecture d'un point de reprise : ses octets et la position de la prochaine valeur.
+     */
+    struct CCheckpointReader {
+        const char * data;
+        size_t       size;
+        size_t       offset;
+    };
+
+    /*!
+     * \fn bool GetValue (CCheckpointReader & reader, T & value)
+     * \brief Lit la valeur écrite par PutValue (). Renvoie false si le point de reprise est trop court.
+     */
+    template <typename T>
+    bool GetValue (CCheckpointReader & reader, T & value){
+        if (reader.size - reader.offset < sizeof (value)) return false;
+        memcpy (&value, reader.data + reader.offset, sizeof (value));
+        reader.offset += sizeof (value);
+        return true;
+    } // GetValue ()
+
+    /*!
+     * \fn bool GetString (CCheckpointReader & reader, string & text)
+     * \brief Lit la chaîne écrite par PutString ().
+     */
+    bool GetString (CCheckpointReader & reader, string & text){
+        uint32_t length;
+        if (!GetValue (reader, length) || reader.size - reader.offset < length) return false;
+        text.assign (reader.data + reader.offset, length);
+        reader.offset += length;
+        return true;
+    } // GetString ()
+
+    /*!
+     * \fn bool GetMatch (CCheckpointReader & reader, CMatchResult & result)
+     * \brief Lit une partie terminée, enregistrée comme dans le journal (EncodeMatch ()).
+     */
+    bool GetMatch (CCheckpointReader & reader, CMatchResult & result){
+        size_t length;
+        if (!DecodeMatch (reader.data + reader.offset, reader.size - reader.offset, result, length)) return false;
+        reader.offset += length;
+        return true;
+    } // GetMatch ()
+
+    /*!
+     * \fn void EncodeSession (string & buffer, const CSession & session)
+     * \brief Ajoute l'état de la série de parties à la fin de buffer. La grille de la partie en cours n'y est pas : ses coups et sa graine suffisent.
+     */
+    void EncodeSession (string & buffer, const CSession & session){
+        PutValue (buffer, uint32_t (session.mode));
+        PutValue (buffer, uint32_t (session.format));
+        PutValue (buffer, session.tokens);
+        PutValue (buffer, session.baseSeed);
+        PutValue (buffer, uint32_t (session.config.matrixSize));
+        PutValue (buffer, session.config.botMs);
+        PutValue (buffer, session.config.clockSeconds);
+        PutValue (buffer, session.checkpointTurns);
+
+        PutValue (buffer, uint32_t (session.VNameColor.size ()));
+        for (unsigned i(0); i < session.VNameColor.size (); ++i){
+            PutString (buffer, session.VNameColor [i].first);
+            PutString (buffer, session.VNameColor [i].second);
+            PutValue (buffer, uint32_t (session.VKind [i]));
+        }
+
+        const CTournament & tour (session.tour);
+        PutValue (buffer, uint32_t (tour.round));
+        PutValue (buffer, uint32_t (tour.VAlive.size ()));
+        for (const unsigned & player : tour.VAlive)
+            PutValue (buffer, uint32_t (player));
+        for (unsigned i(0); i < session.VNameColor.size (); ++i){
+            PutValue (buffer, uint32_t (tour.VPoints [i]));
+            PutValue (buffer, uint32_t (tour.VScore [i]));
+            PutValue (buffer, uint8_t (tour.VBye [i]));
+            PutValue (buffer, uint32_t (tour.VOpponents [i].size ()));
+            for (const unsigned & opponent : tour.VOpponents [i])
+                PutValue (buffer, uint32_t (opponent));
+        }
+
+        PutValue (buffer, session.nbMatches);
+        PutValue (buffer, uint32_t (session.VResult.size ()));
+        for (const CMatchResult & result : session.VResult)
+            EncodeMatch (buffer, result);
+        PutValue (buffer, uint32_t (session.VRoundDone.size ()));
+        for (unsigned k(0); k < session.VRoundDone.size (); ++k){
+            PutValue (buffer, session.VRoundDone [k]);
+            if (session.VRoundDone [k])
+                EncodeMatch (buffer, session.VRoundResult [k]);
+        }
+
+        PutValue (buffer, session.liveMatch);
+        PutValue (buffer, session.live.VClockMs [0]);
+        PutValue (buffer, session.live.VClockMs [1]);
+        PutString (buffer, string (session.live.VMove.begin (), session.live.VMove.end ()));
+    } // EncodeSession ()
+
+    /*!
+     * \fn bool DecodeSession (const string & payload, CSession & session)
+     * \brief Relit l'état écrit par EncodeSession () et vérifie sa cohérence (indices des joueurs, ronde en cours).
+     */
+    bool DecodeSession (const string & payload, CSession & session){
+        CCheckpointReader reader = {payload.data (), payload.size (), 0};
+        uint32_t mode, format, matrixSize, nbPlayers;
+        if (!GetValue (reader, mode) || !GetValue (reader, format) || !GetValue (reader, session.tokens) || !GetValue (reader, session.baseSeed) || !GetValue (reader, matrixSize)
+            || !GetValue (reader, session.config.botMs) || !GetValue (reader, session.config.clockSeconds) || !GetValue (reader, session.checkpointTurns)
+            || !GetValue (reader, nbPlayers)) return false;
+        //! Chaque joueur occupe au moins 29 octets : un nombre aberrant est refusé avant d'allouer quoi que ce soit.
+        if ((mode != 1 && mode != 2) || format > KSwiss || matrixSize <= 1 || nbPlayers < 2 || nbPlayers > payload.size () / 29) return false;
+        session.mode              = mode;
+        session.format            = TTournament (format);
+        session.config.matrixSize = matrixSize;
+
+        session.VNameColor.resize (nbPlayers);
+        session.VKind.resize (nbPlayers);
+        for (unsigned i(0); i < nbPlayers; ++i){
+            uint32_t kind;
+            if (!GetString (reader, session.VNameColor [i].first) || !GetString (reader, session.VNameColor [i].second) || !GetValue (reader, kind)
+                || kind > KComputerMcts) return false;
+            session.VKind [i] = TPlayerKind (kind);
+        }
+        session.config.hasHuman = find (session.VKind.begin (), session.VKind.end (), KHuman) != session.VKind.end ();
+
+        CTournament & tour (session.tour);
+        InitTournament (tour, session.format, nbPlayers);
+        uint32_t round, nbAlive, value;
+        if (!GetValue (reader, round) || !GetValue (reader, nbAlive) || nbAlive > nbPlayers) return false;
+        tour.round = round;
+        tour.VAlive.resize (nbAlive);
+        for (unsigned & player : tour.VAlive)
+            if (!GetValue (reader, value) || value >= nbPlayers) return false;
+            else player = value;
+        for (unsigned i(0); i < nbPlayers; ++i){
+            uint8_t bye;
+            uint32_t nbOpponents;
+            if (!GetValue (reader, value)) return false;
+            tour.VPoints [i] = value;
+            if (!GetValue (reader, value) || !GetValue (reader, bye) || !GetValue (reader, nbOpponents) || nbOpponents > round) return false;
+            tour.VScore [i] = value;
+            tour.VBye [i]   = bye;
+            tour.VOpponents [i].resize (nbOpponents);
+            for (unsigned & opponent : tour.VOpponents [i])
+                if (!GetValue (reader, value) || value >= nbPlayers) return false;
+                else opponent = value;
+        }
+
+        uint32_t nbResults, nbRound;
+        if (!GetValue (reader, session.nbMatches) || !GetValue (reader, nbResults) || nbResults > session.nbMatches + 1) return false;
+        session.VResult.resize (nbResults);
+        for (CMatchResult & result : session.VResult)
+            if (!GetMatch (reader, result)) return false;
+        //! Une ronde en cours doit être celle que construit le tournoi dans cet état : sa composition n'est pas enregistrée.
+        if (!GetValue (reader, nbRound) || (nbRound != 0 && (mode != 2 || TournamentOver (tour) || nbRound != PairRound (tour).size ()))) return false;
+        session.VRoundDone.assign (nbRound, 0);
+        session.VRoundResult.assign (nbRound, CMatchResult ());
+        for (unsigned k(0); k < nbRound; ++k)
+            if (!GetValue (reader, session.VRoundDone [k]) || (session.VRoundDone [k] && !GetMatch (reader, session.VRoundResult [k]))) return false;
+
+        string moves;
+        if (!GetValue (reader, session.liveMatch) || !GetValue (reader, session.live.VClockMs [0]) || !GetValue (reader, session.live.VClockMs [1])
+            || !GetString (reader, moves) || reader.offset != reader.size) return false;
+        if (session.liveMatch != KNoMatch && (mode == 1 ? session.liveMatch != 0 : session.liveMatch >= nbRound)) return false;
+        session.live.VMove.assign (moves.begin (), moves.end ());
+        return true;
+    } // DecodeSession ()
+
+    /*!
+     * \fn bool LoadSession (CSession & session, uint64_t & sequence)
+     * \brief Relit le plus récent des deux points de reprise, ou l'autre s'il est abîmé.
+     */
+    bool LoadSession (CSession & session, uint64_t & sequence){
+        string payload [2];
+        uint64_t VSequence [2] = {0, 0};
+        bool VValid [2];
+        for (unsigned i(0); i < 2; ++i)
+            VValid [i] = ReadCheckpoint (KCheckpointFiles [i], payload [i], VSequence [i]);
+        for (unsigned pass(0); pass < 2; ++pass){
+            const unsigned latest ((VValid [0] && (!VValid [1] || VSequence [0] > VSequence [1])) ? 0 : 1);
+            if (!VValid [latest]) return false;
+            if (DecodeSession (payload [latest], session)){
+                sequence = max (VSequence [0], VSequence [1]);
+                //! Le prochain point de reprise remplace l'autre fichier : celui-ci reste intact jusqu'à ce qu'il soit écrit.
+                Checkpointer.slot = latest ^ 1;
+                return true;
+            }
+            VValid [latest] = false;
+        }
+        return false;
+    } // LoadSession ()
+
+    /*!
+     * \fn int PlaySession (CSession & session, CTelemetry & matchTelemetry)
+     * \brief Joue la série de parties à partir de son état (nouvelle, ou relue à un point de reprise), annonce les vainqueurs et propose la sauvegarde.
+     */
+    int PlaySession (CSession & session, CTelemetry & matchTelemetry){
+        CVPairStr &          VNameColor (session.VNameColor);
+        const CMatchConfig & config (session.config);
+        //! 621. Vecteur qui contiendra les "indices" des gagnants dans VNameColor.
+        vector<unsigned> nbWinners;
+
+        //! 658. Passage en mode non canonique, une seule fois pour toutes les parties, s'il y a un joueur humain.
+        if (config.hasHuman) set_input_mode ();
+
+        if (session.mode == 1){
+            //! 624. Duel : une seule partie entre les deux joueurs.
+            if (session.VResult.empty ()){
+                session.liveMatch = 0;
+                const CMatchResult result (PlayMatch (VNameColor, session.VKind.data (), config, MatchSeed (session.baseSeed, 0), matchTelemetry, session.live));
+                session.VResult.push_back (result);
+                session.liveMatch = KNoMatch;
+                SaveCheckpoint ();
+            }
+            if (session.VResult.back ().winner != 0)
+                nbWinners.push_back (session.VResult.back ().winner - 1);
+        }
+        else if (session.mode == 3){
+            //! Mêlée : tous les joueurs sur la même grille.
+            vector<unsigned> VScore;
+            const unsigned winner (PlayMelee (VNameColor, session.VKind, config, MatchSeed (session.baseSeed, 0), VScore));
+            if (winner != 0)
+                nbWinners.push_back (winner - 1);
+        }
+        else {
+            //! 624. Tournoi : chaque ronde est construite à partir des résultats des précédentes, jusqu'au dernier qualifié ou à la dernière ronde.
+            CTournament & tour (session.tour);
+            while (!TournamentOver (tour)){
+                const vector<CPairing> VPairing (PairRound (tour));
+                //! Une ronde reprise garde les parties déjà terminées ; les exemptions n'ont pas de partie.
+                if (session.VRoundDone.empty ()){
+                    session.VRoundResult.assign (VPairing.size (), CMatchResult ());
+                    session.VRoundDone.assign (VPairing.size (), 0);
+                    for (unsigned k(0); k < VPairing.size (); ++k)
+                        session.VRoundDone [k] = VPairing [k].second == KBye;
+                }
+                //! Les parties sont numérotées d'une ronde à l'autre : chacune a sa graine MatchSeed (baseSeed, numéro).
+                PlayRound (session, VPairing, matchTelemetry);
+
+                vector<CMatchResult> VRoundResult;
+                VRoundResult.swap (session.VRoundResult);
+                session.VRoundDone.clear ();
+                session.nbMatches += VPairing.size ();
+                RecordRound (tour, VPairing, VRoundResult);
+                for (unsigned k(0); k < VPairing.size (); ++k)
+                    if (VPairing [k].second != KBye)
+                        session.VResult.push_back (VRoundResult [k]);
+                SaveCheckpoint ();
+                ShowRound (tour, VNameColor, VPairing, VRoundResult);
+                Pause (config.hasHuman);
+            }
+            nbWinners.push_back (Standings (tour).front ());
+
+            //! Classement final : points, puis pièces ramassées.
+            ClearScreen ();
+            cout << "Classement du tournoi :" << endl;
+            const vector<unsigned> VRank (Standings (tour));
+            for (unsigned i(0); i < VRank.size (); ++i){
+                cout << setw (4) << i + 1 << ". ";
+                ShowColoredName (VNameColor [VRank [i]]);
+                cout << tour.VPoints [VRank [i]] << " points, " << tour.VScore [VRank [i]] << " pièces" << endl;
+            }
+            cout << endl;
+        }
+
+        //! 744. Affichage des pseudos des gagnants de la bonne couleur. On affiche les pseudo/couleur des gagnants de VNameColor repérés par les valeurs de nbWinners en indice.
+        if (session.mode == 1) ClearScreen ();
+        cout << ((session.mode == 1) ? ("Le vainqueur a été :") : (session.mode == 2) ? ("Le vainqueur du tournoi est :") : ("Le vainqueur de la mêlée est :")) << endl;
+        if (nbWinners.empty ())
+            cout << "personne, match nul." << endl;
+        for (unsigned val : nbWinners){
+            Couleur (VNameColor [val].second);
+            cout << VNameColor [val].first << endl;
+            Couleur (KReset);
+        }
+
+        //! Retour en mode canonique pour les dernières saisies, qui passent par cin.
+        if (config.hasHuman) reset_input_mode ();
+
+        //! 753. On propose à l'utilisateur d'enregistrer le résultat {des, de la} partie(s) dans un fichier Resultat.txt qui est créé s'il n'existe pas.
+        //! Le journal ne contient que des parties à deux joueurs : une mêlée n'y est pas enregistrée.
+        if (!session.VResult.empty ()){
+            char doesSave;
+            cout << endl << "Souhaitez-vous enregistrer les résultats des parties ? ('o' ou 'n') ";
+            ShowPrompt (doesSave);
+
+            while (doesSave != 'o' && doesSave != 'n'){
+                cout << "Saisie incorrecte. Veuillez saisir 'o' ou 'n' : ";
+                ShowPrompt (doesSave);
+            }
+
+            if (doesSave == 'o')
+                SaveNames (session.VResult);
+        }
+        //! La série est terminée et ses résultats sont sauvegardés ou refusés : il n'y a plus rien à reprendre.
+        FinishCheckpoints ();
+
+        //! 766. Retour en mode canonique.
+        reset_input_mode ();
 
-                cout << endl;
-                ColorChoose (color);
+        cout << endl;
+        return 0;
+    } // PlaySession ()
 
-                CPairString NameColor = make_pair (name, color);
-                VNameColor.push_back (NameColor);
+    /*!
+     * \fn int BatchMain (int argc, char * argv [], const uint64_t & baseSeed)
+     * \brief Mode tournoi en lot : --batch nbJoueurs taille [threads]. Les joueurs sont des ordinateurs, les résultats sont sauvegardés directement.
+     */
+    int BatchMain (int argc, char * argv [], const uint64_t & baseSeed){
+        if (argc < 4){
+            cerr << "Usage : " << argv [0] << " --batch nbJoueurs taille [threads]" << endl;
+            return EXIT_FAILURE;
+        }
+        const unsigned nbPlayers  (strtoul (argv [2], nullptr, 10));
+        const unsigned matrixSize (strtoul (argv [3], nullptr, 10));
+        const unsigned nbThreads  (argc > 4 ? strtoul (argv [4], nullptr, 10) : thread::hardware_concurrency ());
+        if (nbPlayers < 2 || nbPlayers % 2 != 0 || matrixSize <= 1){
+            cerr << "Il faut un nombre pair de joueurs et une taille supérieure à 1." << endl;
+            return EXIT_FAILURE;
+        }
 
-                ++nb;
+        const string KColors [] = {KRouge, KVert, KJaune, KBleu, KMagenta, KCyan};
+        CVPairStr VNameColor;
+        for (unsigned i(0); i < nbPlayers; ++i)
+            VNameColor.push_back (make_pair ("Ordi" + to_string (i + 1), KColors [i % 6]));
+
+        vector<CMatchResult> VResult;
+        RunBatch (VNameColor, matrixSize, baseSeed, nbThreads, VResult);
+
+        unsigned nbDecisive (0);
+        for (const CMatchResult & result : VResult)
+            if (result.outcome != KOutcomePoints) ++nbDecisive;
+        cout << nbPlayers / 2 << " parties jouées avec la graine " << baseSeed << ", " << nbDecisive << " gagnées par capture ou carré rouge." << endl;
+        SaveNames (VResult);
+        return 0;
+    } // BatchMain ()
+
+    /*!
+     * \fn int ReplayMain (int argc, char * argv [])
+     * \brief Mode rejeu : --replay taille graine coups. Rejoue la partie sans saisie et affiche la grille finale et le résultat.
+     */
+    int ReplayMain (int argc, char * argv []){
+        if (argc < 5){
+            cerr << "Usage : " << argv [0] << " --replay taille graine coups" << endl;
+            return EXIT_FAILURE;
+        }
+        const unsigned matrixSize (strtoul (argv [2], nullptr, 10));
+        const uint64_t seed       (strtoull (argv [3], nullptr, 10));
+        const string   moves      (argv [4]);
+        if (matrixSize <= 1){
+            cerr << "Veuillez saisir une taille supérieure à 1." << endl;
+            return EXIT_FAILURE;
+        }
+
+        CGameState game;
+        const bool ok (ReplayGame (game, matrixSize, seed, vector<char> (moves.begin (), moves.end ())));
+        const CVPairStr VNameColor {make_pair (string ("Joueur1"), KRouge), make_pair (string ("Joueur2"), KVert)};
+        ShowMatrix (game, VNameColor, 0, false);
+        if (!ok)
+            cout << "Coup refusé après " << game.VMove.size () << " coups." << endl;
+        cout << "Vainqueur : " << game.winner << " (0 : pas de capture), score " << game.VScore [0] << " / " << game.VScore [1] << ", " << game.compteTour << " tours restants." << endl;
+        return ok ? 0 : EXIT_FAILURE;
+    } // ReplayMain ()
+
+    /*!
+     * \struct CScriptReader
+     * \brief Lecture ligne à ligne d'un script (--script). Un fichier est projeté en mémoire et ses lignes sont lues sur place ;
+     * une entrée qui ne peut pas l'être (tube) est lue par blocs de 64 Kio dans buffer. Une ligne rendue reste valide jusqu'à la suivante.
+     */
+    struct CScriptReader {
+        int          fd;
+        //! Contenu projeté (map != MAP_FAILED) ou blocs lus (buffer).
+        void *       map;
+        const char * data;
+        size_t       size;
+        string       buffer;
+        //! Début de la prochaine ligne dans data ou dans buffer.
+        size_t       pos;
+        bool         eof;
+    };
+
+    /*!
+     * \fn bool OpenScript (CScriptReader & reader, const string & path)
+     * \brief Ouvre le script path ("-" : l'entrée standard). Renvoie false si le fichier ne peut pas être ouvert.
+     */
+    bool OpenScript (CScriptReader & reader, const string & path){
+        reader.fd   = (path == "-") ? STDIN_FILENO : open (path.c_str (), O_RDONLY | O_CLOEXEC);
+        reader.map  = MAP_FAILED;
+        reader.data = nullptr;
+        reader.size = reader.pos = 0;
+        reader.eof  = false;
+        reader.buffer.clear ();
+        if (reader.fd < 0) return false;
+
+        struct stat info;
+        if (fstat (reader.fd, &info) == 0 && S_ISREG (info.st_mode) && info.st_size > 0){
+            reader.map = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, reader.fd, 0);
+            if (reader.map != MAP_FAILED){
+                madvise (reader.map, info.st_size, MADV_SEQUENTIAL);
+                reader.data = static_cast<const char *> (reader.map);
+                reader.size = info.st_size;
+                reader.eof  = true;
             }
         }
-        return VNameColor;
-    } // InitPlayers ()
+        return true;
+    } // OpenScript ()
 
     /*!
-     * \fn void SaveNames (const CVPairStr & VNameColor, const vector<unsigned> & nbWinners, const vector<unsigned> & VScore)
-     * \brief Effectue la sauvegarde du nom des gagnants dans un fichier.
+     * \fn void CloseScript (CScriptReader & reader)
+     * \brief Libère la projection et ferme le fichier du script.
      */
-    void SaveNames (const CVPairStr & VNameColor, const vector<unsigned> & nbWinners, const vector<unsigned> & VScore){
-        ofstream ofs ("Resultats.txt", ios_base::app);
-        ofs << "Liste des gagnants :" << endl;
+    void CloseScript (CScriptReader & reader){
+        if (reader.map != MAP_FAILED) munmap (reader.map, reader.size);
+        if (reader.fd > STDIN_FILENO) close (reader.fd);
+        reader.map = MAP_FAILED;
+        reader.fd  = -1;
+    } // CloseScript ()
 
-        for (unsigned i(0), j(0); i < VNameColor.size(); i += 2, ++j){
-            unsigned score (VScore [nbWinners [j]]);
-            ofs << VNameColor [i].first << " vs. " << VNameColor [i + 1].first << " : " << VNameColor [nbWinners [j]].first << " a gagné avec " << score << ((score == 1) ? (" point") : (" points"));
+    /*!
+     * \fn bool NextScriptLine (CScriptReader & reader, const char * & line, size_t & length)
+     * \brief Ligne suivante du script, sans sa fin de ligne. Renvoie false à la fin du script.
+     */
+    bool NextScriptLine (CScriptReader & reader, const char * & line, size_t & length){
+        if (reader.map == MAP_FAILED){
+            //! Lecture par blocs : tant que la ligne n'est pas complète, on garde son début et on lit la suite.
+            while (!reader.eof && !memchr (reader.buffer.data () + reader.pos, '\n', reader.buffer.size () - reader.pos)){
+                reader.buffer.erase (0, reader.pos);
+                reader.pos = 0;
+                const size_t used (reader.buffer.size ());
+                reader.buffer.resize (used + 65536);
+                const ssize_t got (read (reader.fd, &reader.buffer [used], 65536));
+                if (got < 0 && errno == EINTR){
+                    reader.buffer.resize (used);
+                    continue;
+                }
+                reader.buffer.resize (used + max (got, ssize_t (0)));
+                if (got <= 0) reader.eof = true;
+            }
+            reader.data = reader.buffer.data ();
+            reader.size = reader.buffer.size ();
         }
-        ofs << endl;
-        cout << endl << "Résultats sauvegardés." << endl;
-    } // SaveNames ()
+        if (reader.pos >= reader.size) return false;
+
+        line = reader.data + reader.pos;
+        const char * end (static_cast<const char *> (memchr (line, '\n', reader.size - reader.pos)));
+        length = end ? end - line : reader.size - reader.pos;
+        reader.pos += length + (end ? 1 : 0);
+        if (length > 0 && line [length - 1] == '\r') --length;
+        return true;
+    } // NextScriptLine ()
+
+    /*!
+     * \fn bool NextScriptToken (const char * & cursor, const char * end, const char * & token, size_t & length)
+     * \brief Mot suivant d'une ligne de script, séparé par des blancs. Renvoie false s'il n'y en a plus.
+     */
+    bool NextScriptToken (const char * & cursor, const char * end, const char * & token, size_t & length){
+        while (cursor < end && isspace ((unsigned char) *cursor)) ++cursor;
+        if (cursor == end) return false;
+        token = cursor;
+        while (cursor < end && !isspace ((unsigned char) *cursor)) ++cursor;
+        length = cursor - token;
+        return true;
+    } // NextScriptToken ()
 
     /*!
-     * \fn CPosition GeneratePosition (const unsigned & matrixSize, const CPosition & posPlayer1, const CPosition & posPlayer2)
-     * \brief Génère des positions différentes de celles des joueurs pour les pions spéciaux.
+     * \fn int ScriptMain (int argc, char * argv [], const uint64_t & baseSeed)
+     * \brief Mode script : --script [fichier|-]. Joue sans affichage ni saisie au clavier les parties décrites dans le fichier (l'entrée standard par défaut),
+     * et écrit une ligne de résultat par partie :
+     *     partie numéro nom1 nom2 score1 score2 vainqueur (0 : nul) issue coups_joués graine [refus coup_refusé]
+     * Le script est fait de lignes "mot valeurs", les lignes vides et celles commençant par '#' sont ignorées :
+     *     mode 1|2                  duel (les parties opposent toujours les deux joueurs) ou multijoueur (joueurs 1-2, puis 3-4, ...)
+     *     taille N                  taille de la grille
+     *     graine N                  graine de la série, comme --seed
+     *     joueur nom [couleur]      ajoute un joueur (couleur 1 à 6 comme au clavier)
+     *     coups [graine] touches    joue une partie avec ces touches, avec la graine donnée ou celle de son numéro dans la série
+     * \return 0 si tous les coups ont été acceptés.
      */
-    CPosition GeneratePosition (const unsigned & matrixSize, const CPosition & posPlayer1, const CPosition & posPlayer2){
-        //! Les coordonnées du token sont tirées au hasard dans les bornes de la matrice, et ne peuvent pas valoir les coordonnées des joueurs (grâce aux while).
-        unsigned x_token = rand() % matrixSize;
-        while (x_token == posPlayer1.first || x_token == posPlayer2.first)
-            x_token = rand() % matrixSize;
+    int ScriptMain (int argc, char * argv [], const uint64_t & baseSeed){
+        const string path (argc > 2 ? argv [2] : "-");
+        CScriptReader reader;
+        if (!OpenScript (reader, path)){
+            cerr << "Impossible d'ouvrir " << path << "." << endl;
+            return EXIT_FAILURE;
+        }
 
-        unsigned y_token = rand() % matrixSize;
-        while (y_token == posPlayer1.second || y_token == posPlayer2.second)
-            y_token = rand() % matrixSize;
+        const string     KColors []    = {KRouge, KVert, KJaune, KBleu, KMagenta, KCyan};
+        const char *     KOutcome []   = {"points", "capture", "carre_rouge", "temps"};
+        unsigned         mode (2), matrixSize (0), lineNumber (0);
+        uint64_t         seriesSeed (baseSeed), nbMatches (0);
+        CVPairStr        VNameColor;
+        CGameState       game;
+        string           output;
+        int              status (0);
+        game.telemetry = SharedTelemetry ();
 
-        CPosition posToken = make_pair (x_token, y_token);
-        return posToken;
-    } // GeneratePosition ()
+        const char * line;
+        size_t       length;
+        while (NextScriptLine (reader, line, length)){
+            ++lineNumber;
+            const char * cursor (line);
+            const char * end (line + length);
+            const char * token;
+            size_t       tokenLength;
+            if (!NextScriptToken (cursor, end, token, tokenLength) || *token == '#') continue;
+            const string command (token, tokenLength);
+
+            string argument;
+            if (NextScriptToken (cursor, end, token, tokenLength))
+                argument.assign (token, tokenLength);
+
+            if (command == "mode")
+                mode = (argument == "1") ? 1 : 2;
+            else if (command == "taille")
+                matrixSize = strtoul (argument.c_str (), nullptr, 10);
+            else if (command == "graine")
+                seriesSeed = strtoull (argument.c_str (), nullptr, 10);
+            else if (command == "joueur" && !argument.empty ()){
+                string color;
+                if (NextScriptToken (cursor, end, token, tokenLength))
+                    color.assign (token, tokenLength);
+                const unsigned choice (strtoul (color.c_str (), nullptr, 10));
+                VNameColor.push_back (make_pair (argument, KColors [(choice >= 1 && choice <= 6) ? choice - 1 : VNameColor.size () % 6]));
+            }
+            else if (command == "coups"){
+                if (matrixSize <= 1 || VNameColor.size () < 2){
+                    cerr << path << ":" << lineNumber << " : il faut une taille supérieure à 1 et au moins deux joueurs avant les coups." << endl;
+                    status = EXIT_FAILURE;
+                    break;
+                }
+                //! Une graine explicite précède les touches ; les touches, elles, ne sont jamais des chiffres.
+                uint64_t seed (MatchSeed (seriesSeed, nbMatches));
+                const char * moves (argument.empty () ? end : token);
+                if (!argument.empty () && isdigit ((unsigned char) argument [0])){
+                    seed  = strtoull (argument.c_str (), nullptr, 10);
+                    moves = NextScriptToken (cursor, end, token, tokenLength) ? token : end;
+                }
+                const unsigned player1 ((mode == 1) ? 0 : (2 * nbMatches) % VNameColor.size ());
+                const unsigned player2 ((mode == 1) ? 1 : (player1 + 1) % VNameColor.size ());
+                ++nbMatches;
+
+                //! Les touches sont jouées sur place, sans copie de la ligne.
+                InitGame (game, matrixSize, seed);
+                size_t refused (0);
+                for (const char * move (moves); move < end && !isspace ((unsigned char) *move); ++move)
+                    if (Step (game, *move) != KStepOk){
+                        refused = move - moves + 1;
+                        break;
+                    }
+                const CMatchResult result (MatchResult (game, VNameColor [player1].first, VNameColor [player2].first));
+                output += "partie " + to_string (nbMatches) + ' ' + result.names [0] + ' ' + result.names [1] + ' '
+                        + to_string (result.VScore [0]) + ' ' + to_string (result.VScore [1]) + ' ' + to_string (result.winner) + ' '
+                        + KOutcome [result.outcome] + ' ' + to_string (game.VMove.size ()) + ' ' + to_string (seed);
+                if (refused){
+                    output += " refus " + to_string (refused);
+                    status = EXIT_FAILURE;
+                }
+                output += '\n';
+                if (output.size () >= 65536){
+                    WriteAll (output);
+                    output.clear ();
+                }
+            }
+            else {
+                cerr << path << ":" << lineNumber << " : ligne inconnue." << endl;
+                status = EXIT_FAILURE;
+            }
+        }
+        WriteAll (output);
+        CloseScript (reader);
+        return status;
+    } // ScriptMain ()
 
     /*!
-     * \brief Fait apparaitre le carré rouge aléatoirement.
+     * \fn int StatsMain (int argc, char * argv [])
+     * \brief Mode statistiques : --stats [journal]. Parcourt le journal binaire et affiche taux de victoire, durée moyenne et rendement des pièces.
      */
-    void MakeRedSquareAppear (CMatrix         & mat,
-                              const char      & KTokenRedSquare,
-                              bool            & doesRedSquare,
-                              CPosition       & posRedSquare,
-                              const unsigned  & chance,
-                              const unsigned  & matrixSize,
-                              const CPosition & posPlayer1,
-                              const CPosition & posPlayer2){
-        unsigned random = rand() % 100;
-        if (random < chance){
-			//! Empêchera la génération d'autres carrés rouges.
-            doesRedSquare = false; 
-            posRedSquare = GeneratePosition (matrixSize, posPlayer1, posPlayer2);
+    int StatsMain (int argc, char * argv []){
+        const string path (argc > 2 ? argv [2] : KMatchLog);
 
-            //! Le token est introduit dans la matrice.
-            mat[posRedSquare.first][posRedSquare.second] = KTokenRedSquare;
+        struct CPlayerStats {
+            unsigned long long games = 0, wins = 0, draws = 0, coins = 0;
+        };
+        unsigned long long nbMatches (0), nbMoves (0), nbCoins (0), nbDraws (0);
+        unsigned long long VOutcome [4] = {0, 0, 0, 0}, VWinnerSide [2] = {0, 0};
+        unordered_map<string, CPlayerStats> players;
+
+        unsigned nbCorrupt;
+        size_t   offset (0);
+        const bool ok (ReadMatchLog (path, [&] (const CMatchResult & result){
+            ++nbMatches;
+            nbMoves += result.VMove.size ();
+            nbCoins += result.VScore [0] + result.VScore [1];
+            if (result.winner == 0) ++nbDraws;
+            else {
+                ++VOutcome [result.outcome];
+                ++VWinnerSide [result.winner - 1];
+            }
+            for (unsigned side(0); side < 2; ++side){
+                CPlayerStats & stats (players [result.names [side]]);
+                ++stats.games;
+                stats.coins += result.VScore [side];
+                if (result.winner == side + 1) ++stats.wins;
+                else if (result.winner == 0)   ++stats.draws;
+            }
+        }, nbCorrupt, offset));
+        if (!ok){
+            cerr << path << " n'est pas un journal de parties lisible." << endl;
+            return EXIT_FAILURE;
         }
-    } // MakeRedSquareAppear ()
+
+        const double matches (max (nbMatches, 1ULL));
+        cout << nbMatches << " parties (" << nbCorrupt << " enregistrements abîmés ignorés)." << endl
+             << fixed << setprecision (1)
+             << "Victoires : " << 100.0 * VOutcome [KOutcomeCapture] / matches << " % par capture, "
+             << 100.0 * VOutcome [KOutcomeRedSquare] / matches << " % par carré rouge, "
+             << 100.0 * VOutcome [KOutcomeTime] / matches << " % au temps, "
+             << 100.0 * VOutcome [KOutcomePoints] / matches << " % aux points, " << 100.0 * nbDraws / matches << " % de matchs nuls." << endl
+             << "Joueur 1 : " << 100.0 * VWinnerSide [0] / matches << " % de victoires, joueur 2 : " << 100.0 * VWinnerSide [1] / matches << " %." << endl
+             << "Durée moyenne : " << nbMoves / matches / 2 << " tours." << endl
+             << "Pièces : " << nbCoins / matches << " par partie, " << 100.0 * nbCoins / max (nbMoves, 1ULL) << " pour 100 coups." << endl;
+
+        //! Classement par taux de victoire, puis par nombre de parties.
+        vector<pair<string, CPlayerStats> > VPlayer (players.begin (), players.end ());
+        sort (VPlayer.begin (), VPlayer.end (), [] (const pair<string, CPlayerStats> & a, const pair<string, CPlayerStats> & b){
+            if (a.second.wins * b.second.games != b.second.wins * a.second.games)
+                return a.second.wins * b.second.games > b.second.wins * a.second.games;
+            return a.second.games > b.second.games;
+        });
+        //! Seuls les 20 premiers sont affichés.
+        if (VPlayer.size () > 20) VPlayer.resize (20);
+        for (const pair<string, CPlayerStats> & player : VPlayer)
+            cout << setw (20) << left << player.first << right << setw (8) << player.second.games << " parties "
+                 << setw (6) << 100.0 * player.second.wins / player.second.games << " % gagnées "
+                 << setw (6) << 100.0 * player.second.draws / player.second.games << " % nulles "
+                 << setw (6) << double (player.second.coins) / player.second.games << " pièces/partie" << endl;
+        return 0;
+    } // StatsMain ()
 
     /*!
-     * \brief Fait apparaitre des pièces aléatoirement.
+     * \fn int LeaderboardMain (int argc, char * argv [])
+     * \brief Mode classement : --leaderboard [noms]. Met l'index à jour avec les nouvelles parties du journal, puis affiche
+     * le classement des joueurs nommés, ou les 20 meilleurs si aucun nom n'est donné.
      */
-    void MakeCoinAppear (CMatrix           & mat,
-                         const char        & KTokenCoin,
-                         vector<CPosition> & VPosCoin,
-                         const unsigned    & chance,
-                         const unsigned    & matrixSize,
-                         const CPosition   & posPlayer1,
-                         const CPosition   & posPlayer2){
-        unsigned random = rand() % 100;
-        if (random < chance){
-            CPosition pos = GeneratePosition (matrixSize, posPlayer1, posPlayer2);
-            mat[pos.first][pos.second] = KTokenCoin;
+    int LeaderboardMain (int argc, char * argv []){
+        CLeaderboard board;
+        if (!OpenLeaderboard (board, KLeaderboard)){
+            cerr << "Impossible d'ouvrir " << KLeaderboard << "." << endl;
+            return EXIT_FAILURE;
+        }
+        if (!SyncLeaderboard (board, KMatchLog))
+            cerr << KMatchLog << " n'est pas un journal de parties lisible." << endl;
 
-            //! Les positions générées sont introduites dans VPosCoin pour pouvoir les comparer avec la position des joueurs plus tard.
-            VPosCoin.push_back (pos);
+        vector<const CEloSlot *> VSlot;
+        if (argc > 2){
+            for (int i(2); i < argc; ++i){
+                const CEloSlot * slot (FindSlot (board, argv [i], NameKey (argv [i])));
+                if (slot->key == 0)
+                    cout << argv [i] << " n'a encore joué aucune partie." << endl;
+                else
+                    VSlot.push_back (slot);
+            }
         }
-    } // MakeCoinAppear ()
+        else {
+            for (uint32_t i(0); i < board.header->capacity; ++i)
+                if (board.slots [i].key != 0) VSlot.push_back (&board.slots [i]);
+            const size_t nbShown (min<size_t> (VSlot.size (), 20));
+            partial_sort (VSlot.begin (), VSlot.begin () + nbShown, VSlot.end (), [] (const CEloSlot * a, const CEloSlot * b){ return a->rating > b->rating; });
+            VSlot.resize (nbShown);
+        }
+
+        cout << board.header->nbPlayers << " joueurs classés." << endl << fixed << setprecision (0);
+        for (const CEloSlot * slot : VSlot)
+            cout << setw (6) << PlayerRank (board, *slot) << ". " << setw (36) << left << string (slot->name, slot->nameLength) << right
+                 << setw (6) << slot->rating << " Elo " << setw (8) << slot->games << " parties " << setw (8) << slot->wins << " victoires" << endl;
+        CloseLeaderboard (board);
+        return 0;
+    } // LeaderboardMain ()
+
+    struct CServerGame;
+
+    /*!
+     * \struct CConnection
+     * \brief Un client du serveur : sa socket, ce qui reste à lui envoyer, l'image de l'écran qu'il affiche et sa place dans une partie.
+     * \var closing la connexion est fermée dès que out est vide : le serveur cesse d'émettre, puis attend que le client ferme en ignorant ce qu'il envoie encore,
+     * pour que la fin de la partie ne soit pas effacée par un RST.
+     */
+    struct CConnection {
+        int                     fd;
+        string                  out;
+        CFrame                  screen;
+        shared_ptr<CServerGame> game;
+        unsigned                side;
+        bool                    closing;
+        bool                    shutDown;
+        bool                    watchingOut;
+    };
+
+    /*!
+     * \struct CServerGame
+     * \brief Une partie hébergée : l'état du moteur, les noms et couleurs affichés et les deux connexions qui la jouent.
+     */
+    struct CServerGame {
+        CGameState    state;
+        CVPairStr     VNameColor;
+        CConnection * players [2];
+    };
+
+    /*!
+     * \struct CServerLoop
+     * \brief Boucle d'événements d'un coeur : son epoll et ses connexions. Une partie reste dans la boucle où elle a commencé.
+     */
+    struct CServerLoop {
+        int                                          epfd;
+        int                                          listenFd;
+        unsigned                                     matrixSize;
+        uint64_t                                     baseSeed;
+        atomic<uint64_t> *                           nbMatches;
+        unordered_map<int, unique_ptr<CConnection> > connections;
+    };
+
+    //! Les parties du serveur sont ajoutées au journal par plusieurs boucles.
+    mutex ServerLogLock;
+    //! Client qui attend un adversaire, partagé par toutes les boucles : il n'est surveillé par aucune jusqu'à ce qu'il soit apparié.
+    mutex ServerWaitingLock;
+    int   ServerWaitingFd = -1;
+
+    /*!
+     * \fn int ListenSocket (const string & address)
+     * \brief Ouvre la socket d'écoute non bloquante. address est un chemin de socket Unix (avec un '/') ou "[adresse:]port" en TCP, sur 127.0.0.1 par défaut.
+     * \return le descripteur, ou -1 en cas d'erreur.
+     */
+    int ListenSocket (const string & address){
+        int fd;
+        if (address.find ('/') != string::npos){
+            sockaddr_un local;
+            memset (&local, 0, sizeof (local));
+            local.sun_family = AF_UNIX;
+            if (address.size () >= sizeof (local.sun_path)) return -1;
+            memcpy (local.sun_path, address.c_str (), address.size () + 1);
+            unlink (address.c_str ());
+            fd = socket (AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) return -1;
+            if (bind (fd, reinterpret_cast<sockaddr *> (&local), sizeof (local)) != 0){
+                close (fd);
+                return -1;
+            }
+        }
+        else {
+            const size_t colon (address.rfind (':'));
+            const string host (colon == string::npos ? "127.0.0.1" : address.substr (0, colon));
+            sockaddr_in local;
+            memset (&local, 0, sizeof (local));
+            local.sin_family = AF_INET;
+            local.sin_port   = htons (strtoul (address.c_str () + (colon == string::npos ? 0 : colon + 1), nullptr, 10));
+            if (inet_pton (AF_INET, host.c_str (), &local.sin_addr) != 1) return -1;
+            fd = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) return -1;
+            const int yes (1);
+            setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof (yes));
+            if (bind (fd, reinterpret_cast<sockaddr *> (&local), sizeof (local)) != 0){
+                close (fd);
+                return -1;
+            }
+        }
+        if (listen (fd, SOMAXCONN) != 0){
+            close (fd);
+            return -1;
+        }
+        return fd;
+    } // ListenSocket ()
+
+    /*!
+     * \fn void CloseConnection (CServerLoop & loop, CConnection & conn)
+     * \brief Ferme la connexion et l'oublie. L'adversaire d'une partie en cours est prévenu puis déconnecté.
+     */
+    void CloseConnection (CServerLoop & loop, CConnection & conn);
+
+    /*!
+     * \fn void FlushConnection (CServerLoop & loop, CConnection & conn)
+     * \brief Envoie ce qui peut l'être sans bloquer. Le reste attend EPOLLOUT ; une connexion en fermeture est fermée une fois tout envoyé.
+     */
+    void FlushConnection (CServerLoop & loop, CConnection & conn){
+        size_t done (0);
+        while (done < conn.out.size ()){
+            const ssize_t sent (send (conn.fd, conn.out.data () + done, conn.out.size () - done, MSG_NOSIGNAL));
+            if (sent < 0){
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                conn.out.clear ();
+                conn.closing = true;
+                done = 0;
+                break;
+            }
+            done += sent;
+        }
+        conn.out.erase (0, done);
+
+        if (conn.out.empty () && conn.closing && !conn.shutDown){
+            shutdown (conn.fd, SHUT_WR);
+            conn.shutDown = true;
+        }
+        const bool watchOut (!conn.out.empty ());
+        if (watchOut != conn.watchingOut){
+            epoll_event event;
+            event.events  = EPOLLIN | EPOLLRDHUP | (watchOut ? uint32_t (EPOLLOUT) : 0u);
+            event.data.fd = conn.fd;
+            epoll_ctl (loop.epfd, EPOLL_CTL_MOD, conn.fd, &event);
+            conn.watchingOut = watchOut;
+        }
+    } // FlushConnection ()
+
+    /*!
+     * \fn void SendBoard (CServerGame & game, const bool & showTurn)
+     * \brief Ajoute la grille, dans la mise en page de ShowMatrix (), à ce qui doit être envoyé aux deux joueurs.
+     * Comme à l'écran, seules les cases modifiées depuis la dernière image de chaque client sont envoyées.
+     */
+    void SendBoard (CServerGame & game, const bool & showTurn){
+        const uint64_t start (ProbeStart (game.state.telemetry));
+        CFrame frame;
+        ComposeMatrix (frame, game.state, game.VNameColor, 0, showTurn, KDefaultTermRows, KDefaultTermCols);
+        for (CConnection * conn : game.players){
+            if (!conn) continue;
+            const size_t before (conn->out.size ());
+            if (conn->screen.empty ()) conn->out += "\033[H\033[2J";
+            RenderFrame (conn->screen, frame, conn->out);
+            conn->screen = frame;
+            AddCounter (game.state.telemetry, KCounterBytes, conn->out.size () - before);
+        }
+        ProbeStop (game.state.telemetry, KProbeRender, start);
+    } // SendBoard ()
+
+    void CloseConnection (CServerLoop & loop, CConnection & conn){
+        shared_ptr<CServerGame> game (conn.game);
+        conn.game.reset ();
+        if (game){
+            game->players [conn.side] = nullptr;
+            CConnection * other (game->players [1 - conn.side]);
+            if (other && !IsOver (game->state)){
+                other->out += "\r\nVotre adversaire a quitté la partie.\r\n";
+                other->closing = true;
+                other->game.reset ();
+                game->players [1 - conn.side] = nullptr;
+                FlushConnection (loop, *other);
+            }
+        }
+        epoll_ctl (loop.epfd, EPOLL_CTL_DEL, conn.fd, nullptr);
+        close (conn.fd);
+        loop.connections.erase (conn.fd);
+    } // CloseConnection ()
+
+    /*!
+     * \fn void StartServerGame (CServerLoop & loop, CConnection & player1, CConnection & player2)
+     * \brief Crée une partie entre deux clients et leur envoie la grille.
+     */
+    void StartServerGame (CServerLoop & loop, CConnection & player1, CConnection & player2){
+        const uint64_t match (loop.nbMatches->fetch_add (1));
+        shared_ptr<CServerGame> game (make_shared<CServerGame> ());
+        game->state.telemetry = SharedTelemetry ();
+        game->state.earlyEnd  = true;
+        InitGame (game->state, loop.matrixSize, MatchSeed (loop.baseSeed, match));
+        game->VNameColor.push_back (make_pair ("Joueur" + to_string (2 * match + 1), KRouge));
+        game->VNameColor.push_back (make_pair ("Joueur" + to_string (2 * match + 2), KVert));
+        game->players [0] = &player1;
+        game->players [1] = &player2;
+        player1.game = player2.game = game;
+        player1.side = 0;
+        player2.side = 1;
+        SendBoard (*game, true);
+    } // StartServerGame ()
+
+    /*!
+     * \fn void FinishServerGame (CServerGame & game)
+     * \brief Envoie la grille finale et le résultat, ajoute la partie au journal et ferme les deux connexions une fois tout envoyé.
+     */
+    void FinishServerGame (CServerGame & game){
+        SendBoard (game, false);
+        const CMatchResult result (MatchResult (game.state, game.VNameColor [0].first, game.VNameColor [1].first));
+        const string message ((result.winner == 0) ? string ("Match nul !") : game.VNameColor [result.winner - 1].first + " gagne avec " + to_string (result.VScore [result.winner - 1]) + " points.");
+        for (CConnection * conn : game.players){
+            if (!conn) continue;
+            conn->out += message + "\r\nGraine de la partie : " + to_string (game.state.seed) + " (" + string (game.state.VMove.begin (), game.state.VMove.end ()) + ")\r\n";
+            conn->closing = true;
+        }
+        lock_guard<mutex> guard (ServerLogLock);
+        AppendMatchLog (KMatchLog, vector<CMatchResult> (1, result));
+    } // FinishServerGame ()
+
+    /*!
+     * \fn void ServerInput (CServerLoop & loop, CConnection & conn, const char * data, const size_t & size)
+     * \brief Traite les octets reçus : chaque touche jouée par le client dont c'est le tour passe par Step (). Les blancs sont ignorés.
+     */
+    void ServerInput (CServerLoop & loop, CConnection & conn, const char * data, const size_t & size){
+        for (size_t i(0); i < size && conn.game && !conn.closing; ++i){
+            if (isspace ((unsigned char) data [i])) continue;
+            shared_ptr<CServerGame> game (conn.game);
+            if (game->state.turn != conn.side + 1){
+                conn.out += "\r\nCe n'est pas votre tour.\r\n";
+                continue;
+            }
+            const TStepStatus status (Step (game->state, data [i]));
+            if (status == KStepOutOfBoard || status == KStepBadKey){
+                conn.out += (status == KStepOutOfBoard) ? "\r\nDeplacement impossible.\r\n" : "\r\nSaisie incorrecte.\r\n";
+                continue;
+            }
+            if (IsOver (game->state)) FinishServerGame (*game);
+            else SendBoard (*game, true);
+            for (CConnection * player : game->players)
+                if (player && player != &conn) FlushConnection (loop, *player);
+        }
+    } // ServerInput ()
+
+    /*!
+     * \fn CConnection * AddConnection (CServerLoop & loop, const int & fd)
+     * \brief Confie la socket à la boucle. nullptr (et la socket est fermée) si epoll la refuse.
+     */
+    CConnection * AddConnection (CServerLoop & loop, const int & fd){
+        epoll_event event;
+        event.events  = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl (loop.epfd, EPOLL_CTL_ADD, fd, &event) != 0){
+            close (fd);
+            return nullptr;
+        }
+        unique_ptr<CConnection> conn (new CConnection ());
+        conn->fd   = fd;
+        conn->side = 0;
+        conn->closing = conn->shutDown = conn->watchingOut = false;
+        CConnection * added (conn.get ());
+        loop.connections [fd] = move (conn);
+        return added;
+    } // AddConnection ()
+
+    /*!
+     * \fn bool DrainPendingInput (const int & fd)
+     * \brief Jette ce qu'un client a envoyé avant le début de sa partie : il n'avait pas encore vu la grille.
+     * \return false si le client a fermé la connexion.
+     */
+    bool DrainPendingInput (const int & fd){
+        char buffer [256];
+        for (;;){
+            const ssize_t got (recv (fd, buffer, sizeof (buffer), MSG_DONTWAIT));
+            if (got > 0) continue;
+            return got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        }
+    } // DrainPendingInput ()
+
+    /*!
+     * \fn void AcceptClients (CServerLoop & loop)
+     * \brief Accepte les connexions en attente. Chaque nouveau client affronte celui qui attendait, quelle que soit la boucle qui l'a accepté, ou attend à son tour.
+     */
+    void AcceptClients (CServerLoop & loop){
+        for (;;){
+            const int fd (accept4 (loop.listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+            if (fd < 0) return;
+
+            if (!DrainPendingInput (fd)){
+                close (fd);
+                continue;
+            }
+
+            //! Le client qui attend n'est surveillé par aucune boucle : s'il est parti entre-temps, le nouveau client attend à sa place.
+            int opponentFd;
+            {
+                lock_guard<mutex> guard (ServerWaitingLock);
+                opponentFd = ServerWaitingFd;
+                if (opponentFd >= 0 && !DrainPendingInput (opponentFd)){
+                    close (opponentFd);
+                    opponentFd = -1;
+                }
+                ServerWaitingFd = (opponentFd < 0) ? fd : -1;
+            }
+            if (opponentFd < 0){
+                const string KWelcome ("Bienvenue ! En attente d'un adversaire...\r\n");
+                send (fd, KWelcome.data (), KWelcome.size (), MSG_NOSIGNAL);
+                continue;
+            }
+
+            CConnection * player1 (AddConnection (loop, opponentFd));
+            CConnection * player2 (AddConnection (loop, fd));
+            if (player1 && player2){
+                StartServerGame (loop, *player1, *player2);
+                FlushConnection (loop, *player1);
+                FlushConnection (loop, *player2);
+            }
+            else if (player1 || player2){
+                CConnection & alone (player1 ? *player1 : *player2);
+                alone.out     = "Votre adversaire a quitté la partie.\r\n";
+                alone.closing = true;
+                FlushConnection (loop, alone);
+            }
+        }
+    } // AcceptClients ()
+
+    /*!
+     * \fn void ServerLoop (const int & listenFd, const unsigned & matrixSize, const uint64_t & baseSeed, atomic<uint64_t> & nbMatches)
+     * \brief Boucle d'événements d'un coeur. Toutes les boucles surveillent la socket d'écoute avec EPOLLEXCLUSIVE : une seule est réveillée par connexion.
+     */
+    void ServerLoop (const int & listenFd, const unsigned & matrixSize, const uint64_t & baseSeed, atomic<uint64_t> & nbMatches){
+        CServerLoop loop;
+        loop.epfd       = epoll_create1 (EPOLL_CLOEXEC);
+        loop.listenFd   = listenFd;
+        loop.matrixSize = matrixSize;
+        loop.baseSeed   = baseSeed;
+        loop.nbMatches  = &nbMatches;
+
+        epoll_event event;
+        event.events  = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.fd = listenFd;
+        epoll_ctl (loop.epfd, EPOLL_CTL_ADD, listenFd, &event);
+
+        epoll_event VEvent [256];
+        char        input [4096];
+        for (;;){
+            const int nbEvents (epoll_wait (loop.epfd, VEvent, 256, -1));
+            for (int e(0); e < nbEvents; ++e){
+                const int fd (VEvent [e].data.fd);
+                if (fd == listenFd){
+                    AcceptClients (loop);
+                    continue;
+                }
+                //! La connexion a pu être fermée par un événement précédent de la même série.
+                auto found (loop.connections.find (fd));
+                if (found == loop.connections.end ()) continue;
+                CConnection & conn (*found->second);
+
+                if (VEvent [e].events & EPOLLIN){
+                    ssize_t received;
+                    while ((received = recv (fd, input, sizeof (input), 0)) > 0)
+                        ServerInput (loop, conn, input, received);
+                    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)){
+                        CloseConnection (loop, conn);
+                        continue;
+                    }
+                }
+                else if (VEvent [e].events & (EPOLLERR | EPOLLHUP)){
+                    CloseConnection (loop, conn);
+                    continue;
+                }
+                FlushConnection (loop, conn);
+            }
+        }
+    } // ServerLoop ()
+
+    /*!
+     * \fn int ServeMain (int argc, char * argv [], const uint64_t & baseSeed)
+     * \brief Mode serveur : --serve adresse taille [threads]. Héberge des parties entre clients réseau (telnet, nc...), une boucle epoll par coeur.
+     */
+    int ServeMain (int argc, char * argv [], const uint64_t & baseSeed){
+        if (argc < 4){
+            cerr << "Usage : " << argv [0] << " --serve [adresse:]port|chemin taille [threads]" << endl;
+            return EXIT_FAILURE;
+        }
+        const unsigned matrixSize (strtoul (argv [3], nullptr, 10));
+        unsigned       nbThreads  (argc > 4 ? strtoul (argv [4], nullptr, 10) : thread::hardware_concurrency ());
+        if (matrixSize <= 1){
+            cerr << "Veuillez saisir une taille supérieure à 1." << endl;
+            return EXIT_FAILURE;
+        }
+        nbThreads = max (nbThreads, 1u);
+
+        const int listenFd (ListenSocket (argv [2]));
+        if (listenFd < 0){
+            cerr << "Impossible d'écouter sur " << argv [2] << " : " << strerror (errno) << endl;
+            return EXIT_FAILURE;
+        }
+        signal (SIGPIPE, SIG_IGN);
+        cout << "Serveur prêt sur " << argv [2] << " (" << nbThreads << " boucles)." << endl;
+
+        atomic<uint64_t> nbMatches (0);
+        RunParallel (nbThreads, nbThreads, [&] (unsigned, unsigned){
+            ServerLoop (listenFd, matrixSize, baseSeed, nbMatches);
+        });
+        return 0;
+    } // ServeMain ()
+
+    //! Nombre d'allocations faites par operator new pendant les microbenchmarks. Il n'est compté qu'avec --bench (CountAllocations) :
+    //! ailleurs, les threads des parties en lot, du joueur Monte-Carlo et du serveur ne se disputent pas ce compteur.
+    atomic<unsigned long long> NbAllocations (0);
+    atomic<bool>               CountAllocations (false);
+
+    /*!
+     * \fn void * Allocate (const size_t & size, const size_t & align)
+     * \brief Alloue pour toutes les formes d'operator new, avec malloc () ou posix_memalign () : toutes les formes d'operator delete libèrent avec free ().
+     * Renvoie nullptr si la mémoire manque.
+     */
+    void * Allocate (const size_t & size, const size_t & align){
+        if (CountAllocations.load (memory_order_relaxed))
+            NbAllocations.fetch_add (1, memory_order_relaxed);
+        if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return malloc (size ? size : 1);
+        void * block;
+        return (posix_memalign (&block, align, size ? size : 1) == 0) ? block : nullptr;
+    } // Allocate ()
+
+    /*!
+     * \struct CBenchTimer
+     * \brief Chronomètre d'un microbenchmark : seules les périodes entre Start () et Stop () comptent, en temps comme en allocations.
+     */
+    struct CBenchTimer {
+        unsigned long long               ns;
+        unsigned long long               allocs;
+        unsigned long long               bytes;
+        unsigned long long               allocStart;
+        chrono::steady_clock::time_point start;
+
+        void Start (){
+            allocStart = NbAllocations.load (memory_order_relaxed);
+            start      = chrono::steady_clock::now ();
+        }
+        void Stop (){
+            ns     += chrono::duration_cast<chrono::nanoseconds> (chrono::steady_clock::now () - start).count ();
+            allocs += NbAllocations.load (memory_order_relaxed) - allocStart;
+        }
+    };
+
+    /*!
+     * \fn void RunBench (const string & name, const unsigned & matrixSize, const function<void (CBenchTimer &, const unsigned long long &)> & job)
+     * \brief Lance job avec de plus en plus d'opérations jusqu'à ce que la mesure dure au moins 100 ms, puis écrit une ligne JSON :
+     * nom, taille, opérations, ns/op, allocations/op et octets rendus/op.
+     */
+    void RunBench (const string & name, const unsigned & matrixSize, const function<void (CBenchTimer &, const unsigned long long &)> & job){
+        const unsigned long long KMinNs (100000000);
+        unsigned long long nbOps (1);
+        CBenchTimer timer;
+        for (;;){
+            timer.ns = timer.allocs = timer.bytes = 0;
+            job (timer, nbOps);
+            if (timer.ns >= KMinNs || nbOps >= (1ULL << 32)) break;
+            //! Vise 20 % de plus que le minimum, sans multiplier par plus de 100 d'un essai à l'autre.
+            nbOps = min (nbOps * 100, max (nbOps + 1, (unsigned long long) (nbOps * 1.2 * KMinNs / max (timer.ns, 1ULL))));
+        }
+        cout << "{\"bench\":\"" << name << "\",\"size\":" << matrixSize << ",\"ops\":" << nbOps
+             << fixed << setprecision (1) << ",\"ns_per_op\":" << double (timer.ns) / nbOps
+             << setprecision (3) << ",\"allocs_per_op\":" << double (timer.allocs) / nbOps
+             << setprecision (1) << ",\"bytes_per_op\":" << double (timer.bytes) / nbOps << "}" << endl;
+    } // RunBench ()
+
+    /*!
+     * \fn char BenchMove (const CGameState & game, CRng & rng)
+     * \brief Un coup possible au hasard, pour faire avancer une partie de benchmark.
+     */
+    char BenchMove (const CGameState & game, CRng & rng){
+        unsigned legal (LegalMoves (game.turn == 1 ? game.posPlayer1 : game.posPlayer2, game.matrixSize));
+        for (unsigned skip (RandomBelow (rng, __builtin_popcount (legal))); skip > 0; --skip)
+            legal &= legal - 1;
+        return KMoveKeys [__builtin_ctz (legal)];
+    } // BenchMove ()
+
+    /*!
+     * \fn int BenchMain (int argc, char * argv [])
+     * \brief Mode microbenchmarks : --bench [tailles]. Mesure MoveToken, GeneratePosition, MakeCoinAppear, ShowMatrix (rendu dans une chaîne)
+     * et une partie complète entre joueurs ordinateur, pour chaque taille (4 à 4096 par défaut). Une ligne JSON par mesure, à comparer d'un commit à l'autre.
+     */
+    int BenchMain (int argc, char * argv []){
+        vector<unsigned> VSize;
+        for (int i(2); i < argc; ++i)
+            VSize.push_back (strtoul (argv [i], nullptr, 10));
+        if (VSize.empty ())
+            VSize = {4, 16, 64, 256, 1024, 4096};
+
+        const CVPairStr VNameColor = {make_pair (string ("Joueur1"), string (KRouge)), make_pair (string ("Joueur2"), string (KVert))};
+        CountAllocations.store (true, memory_order_relaxed);
+        for (const unsigned & matrixSize : VSize){
+            if (matrixSize <= 1) continue;
+            CGameState game;
+            CRng       rng;
+            rng.Seed (matrixSize);
+
+            RunBench ("MoveToken", matrixSize, [&] (CBenchTimer & timer, const unsigned long long & nbOps){
+                InitGame (game, matrixSize, matrixSize);
+                for (unsigned long long op(0); op < nbOps; ++op){
+                    if (IsOver (game)) InitGame (game, matrixSize, op);
+                    char      move (BenchMove (game, rng));
+                    long long clockMs (-1);
+                    timer.Start ();
+                    MoveToken (game, move, clockMs);
+                    timer.Stop ();
+                }
+            });
+
+            InitGame (game, matrixSize, matrixSize);
+            RunBench ("GeneratePosition", matrixSize, [&] (CBenchTimer & timer, const unsigned long long & nbOps){
+                size_t sum (0);
+                timer.Start ();
+                for (unsigned long long op(0); op < nbOps; ++op)
+                    sum += GeneratePosition (rng, game.freeCells);
+                timer.Stop ();
+                //! Écrire la somme dans une variable volatile oblige le compilateur à garder les tirages.
+                volatile size_t sink (sum);
+                (void) sink;
+            });
+
+            RunBench ("MakeCoinAppear", matrixSize, [&] (CBenchTimer & timer, const unsigned long long & nbOps){
+                //! Par lots de 64, les pièces apparues sont retirées entre deux lots pour que la grille ne se remplisse pas.
+                const size_t nbCoins (game.VPosCoin.cells.size ());
+                for (unsigned long long op(0); op < nbOps; op += 64){
+                    timer.Start ();
+                    for (unsigned long long i (op); i < min (nbOps, op + 64); ++i)
+                        MakeCoinAppear (rng, game.mat, game.VPosCoin, game.planes [KPlaneCoin], game.chance, game.freeCells);
+                    timer.Stop ();
+                    while (game.VPosCoin.cells.size () > nbCoins){
+                        const size_t cell (game.VPosCoin.cells.back ());
+                        RemoveCoin (game.VPosCoin, game.planes [KPlaneCoin], game.mat, cell);
+                        game.freeCells.Insert (cell);
+                    }
+                }
+            });
+
+            RunBench ("ShowMatrix", matrixSize, [&] (CBenchTimer & timer, const unsigned long long & nbOps){
+                //! Comme à l'écran : une image complète d'abord, puis seulement les différences après chaque coup.
+                CFrame previous, frame;
+                string buffer;
+                InitGame (game, matrixSize, matrixSize);
+                ComposeMatrix (previous, game, VNameColor, 0, true, KDefaultTermRows, KDefaultTermCols);
+                for (unsigned long long op(0); op < nbOps; ++op){
+                    if (IsOver (game)) InitGame (game, matrixSize, op);
+                    Step (game, BenchMove (game, rng));
+                    timer.Start ();
+                    buffer.clear ();
+                    ComposeMatrix (frame, game, VNameColor, 0, true, KDefaultTermRows, KDefaultTermCols);
+                    RenderFrame (previous, frame, buffer);
+                    timer.Stop ();
+                    timer.bytes += buffer.size ();
+                    previous.swap (frame);
+                }
+            });
+
+            RunBench ("Match", matrixSize, [&] (CBenchTimer & timer, const unsigned long long & nbOps){
+                CRng botRng;
+                for (unsigned long long op(0); op < nbOps; ++op){
+                    timer.Start ();
+                    InitGame (game, matrixSize, op);
+                    botRng.Seed (~op);
+                    while (!IsOver (game))
+                        Step (game, BotMove (game, botRng));
+                    timer.Stop ();
+                }
+            });
+        }
+        return 0;
+    } // BenchMain ()
+
+    /*!
+     * \fn bool TakeOption (int & argc, char * argv [], const string & option, string & value)
+     * \brief Cherche l'option "option valeur" dans les arguments et la retire. Renvoie false si elle est absente, value n'est alors pas modifiée.
+     */
+    bool TakeOption (int & argc, char * argv [], const string & option, string & value){
+        for (int i(1); i + 1 < argc; ++i){
+            if (string (argv [i]) != option) continue;
+            value = argv [i + 1];
+            for (int j(i); j + 2 <= argc; ++j)
+                argv [j] = argv [j + 2];
+            argc -= 2;
+            return true;
+        }
+        return false;
+    } // TakeOption ()
+
+    /*!
+     * \fn bool TakeOption (int & argc, char * argv [], const string & option, uint64_t & value)
+     * \brief Cherche l'option "option N" dans les arguments et la retire. Renvoie false si elle est absente, value n'est alors pas modifiée.
+     */
+    bool TakeOption (int & argc, char * argv [], const string & option, uint64_t & value){
+        for (int i(1); i + 1 < argc; ++i){
+            if (string (argv [i]) != option) continue;
+            value = strtoull (argv [i + 1], nullptr, 10);
+            for (int j(i); j + 2 <= argc; ++j)
+                argv [j] = argv [j + 2];
+            argc -= 2;
+            return true;
+        }
+        return false;
+    } // TakeOption ()
 } // namespace
 
-int main (){
-    //! 559. Initialisation de la commande rand ().
-    srand (time(NULL));
+//! Toutes les allocations passent par ici : les microbenchmarks (--bench) comptent les allocations par opération.
+//! Toute la famille est remplacée (tableaux, nothrow, alignées), pour que chaque delete libère ce qu'un de ces new a alloué : les outils comme
+//! -fsanitize=address vérifient cet appariement.
+//! Hors ligne : une fois inlinés, les malloc () et free () de ces fonctions font croire à GCC à des new et delete mal appariés.
+__attribute__ ((noinline)) void * operator new (size_t size){
+    if (void * block = Allocate (size, 0)) return block;
+    throw bad_alloc ();
+}
+__attribute__ ((noinline)) void * operator new [] (size_t size){
+    if (void * block = Allocate (size, 0)) return block;
+    throw bad_alloc ();
+}
+__attribute__ ((noinline)) void * operator new (size_t size, align_val_t align){
+    if (void * block = Allocate (size, size_t (align))) return block;
+    throw bad_alloc ();
+}
+__attribute__ ((noinline)) void * operator new [] (size_t size, align_val_t align){
+    if (void * block = Allocate (size, size_t (align))) return block;
+    throw bad_alloc ();
+}
+__attribute__ ((noinline)) void * operator new (size_t size, const nothrow_t &) noexcept { return Allocate (size, 0); }
+__attribute__ ((noinline)) void * operator new [] (size_t size, const nothrow_t &) noexcept { return Allocate (size, 0); }
+__attribute__ ((noinline)) void * operator new (size_t size, align_val_t align, const nothrow_t &) noexcept { return Allocate (size, size_t (align)); }
+__attribute__ ((noinline)) void * operator new [] (size_t size, align_val_t align, const nothrow_t &) noexcept { return Allocate (size, size_t (align)); }
+__attribute__ ((noinline)) void operator delete (void * block) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete [] (void * block) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete (void * block, size_t) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete [] (void * block, size_t) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete (void * block, align_val_t) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete [] (void * block, align_val_t) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete (void * block, size_t, align_val_t) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete [] (void * block, size_t, align_val_t) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete (void * block, const nothrow_t &) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete [] (void * block, const nothrow_t &) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete (void * block, align_val_t, const nothrow_t &) noexcept { free (block); }
+__attribute__ ((noinline)) void operator delete [] (void * block, align_val_t, const nothrow_t &) noexcept { free (block); }
+
+int main (int argc, char * argv []){
+    //! Graine de la série de parties : --seed N la fixe pour pouvoir rejouer les mêmes apparitions.
+    uint64_t baseSeed ((uint64_t (random_device {} ()) << 32) ^ random_device {} ());
+    TakeOption (argc, argv, "--seed", baseSeed);
+    //! Temps de réflexion des joueurs ordinateur, en millisecondes par coup.
+    uint64_t botMs (500);
+    TakeOption (argc, argv, "--bot-ms", botMs);
+    //! Pendule : secondes de réflexion de chaque joueur humain pour toute une partie, 0 sans limite.
+    uint64_t clockSeconds (0);
+    TakeOption (argc, argv, "--clock", clockSeconds);
+    //! Télémétrie : durées du rendu, de la saisie, des règles et des apparitions, écrites dans ce fichier à la sortie et à chaque SIGUSR1.
+    string telemetryPath;
+    if (TakeOption (argc, argv, "--telemetry", telemetryPath))
+        StartTelemetry (telemetryPath);
+    //! Diffusion des parties affichées aux spectateurs (--spectate nom), par mémoire partagée.
+    string broadcastName;
+    const bool broadcast (TakeOption (argc, argv, "--broadcast", broadcastName));
+    //! Table de finales : coups parfaits des joueurs ordinateur et conseils aux joueurs humains sur les petites grilles.
+    string tablebasePath;
+    if (TakeOption (argc, argv, "--tablebase", tablebasePath) && !OpenTablebase (tablebasePath))
+        cerr << "Table de finales " << tablebasePath << " illisible : elle est ignorée." << endl;
+
+    //! Points de reprise tous les N tours de la partie affichée, et à la fin de chaque partie.
+    uint64_t checkpointOption (0);
+    TakeOption (argc, argv, "--checkpoint", checkpointOption);
+    if (checkpointOption > UINT_MAX){
+        cerr << "--checkpoint N : au plus " << UINT_MAX << " tours entre deux points de reprise." << endl;
+        return EXIT_FAILURE;
+    }
+    const unsigned checkpointTurns = (unsigned) checkpointOption;
+    //! Mesures de la partie affichée en cours, remises à zéro au début de chaque partie.
+    CTelemetry matchTelemetry;
+
+    //! Reprise de la série interrompue au dernier point de reprise.
+    if (argc > 1 && string (argv [1]) == "--resume"){
+        CSession session;
+        uint64_t sequence (0);
+        const chrono::steady_clock::time_point start (chrono::steady_clock::now ());
+        if (!LoadSession (session, sequence)){
+            cerr << "Aucun point de reprise lisible (" << KCheckpointFiles [0] << ", " << KCheckpointFiles [1] << ")." << endl;
+            return EXIT_FAILURE;
+        }
+        cout << "Point de reprise " << sequence << " relu en " << chrono::duration_cast<chrono::microseconds> (chrono::steady_clock::now () - start).count () << " µs : "
+             << session.VResult.size () << " parties terminées";
+        if (session.liveMatch != KNoMatch)
+            cout << ", partie en cours reprise après " << session.live.VMove.size () << " coups";
+        cout << "." << endl;
+        if (broadcast && !StartBroadcast (broadcastName, session.config.matrixSize))
+            cerr << "Diffusion " << broadcastName << " impossible : " << strerror (errno) << endl;
+        //! La reprise garde l'intervalle de la série, sauf si --checkpoint en donne un autre.
+        if (checkpointTurns) session.checkpointTurns = checkpointTurns;
+        TokenPlayer1 = session.tokens [0];
+        TokenPlayer2 = session.tokens [1];
+        StartCheckpoints ([&session] (string & buffer) { EncodeSession (buffer, session); }, session.checkpointTurns, sequence);
+        return PlaySession (session, matchTelemetry);
+    }
+
+    //! Mode tournoi en lot, sans affichage ni saisie.
+    if (argc > 1 && string (argv [1]) == "--batch")
+        return BatchMain (argc, argv, baseSeed);
+    //! Rejeu d'une partie à partir de sa graine et de ses coups.
+    if (argc > 1 && string (argv [1]) == "--replay")
+        return ReplayMain (argc, argv);
+    //! Parties décrites dans un fichier ou un tube, jouées sans affichage.
+    if (argc > 1 && string (argv [1]) == "--script")
+        return ScriptMain (argc, argv, baseSeed);
+    //! Statistiques sur le journal binaire des parties.
+    if (argc > 1 && string (argv [1]) == "--stats")
+        return StatsMain (argc, argv);
+    //! Classement Elo des joueurs.
+    if (argc > 1 && string (argv [1]) == "--leaderboard")
+        return LeaderboardMain (argc, argv);
+    //! Microbenchmarks des fonctions du jeu.
+    if (argc > 1 && string (argv [1]) == "--bench")
+        return BenchMain (argc, argv);
+    //! Serveur de parties en réseau.
+    if (argc > 1 && string (argv [1]) == "--serve")
+        return ServeMain (argc, argv, baseSeed);
+    //! Génération de la table de finales.
+    if (argc > 1 && string (argv [1]) == "--build-tablebase")
+        return TablebaseMain (argc, argv);
+    //! Mêlée sans affichage entre joueurs ordinateur.
+    if (argc > 1 && string (argv [1]) == "--melee")
+        return MeleeMain (argc, argv, baseSeed);
+    //! Spectateur d'une partie diffusée par un autre processus.
+    if (argc > 1 && string (argv [1]) == "--spectate")
+        return SpectateMain (argc, argv);
 
     //! 562. Affichage d'un message de bienvenue.
     ClearScreen();
@@ -583,9 +6356,13 @@ int main (){
     Couleur (KBleu);
     cout << "Multijoueur" << endl;
     Couleur (KReset);
+    cout << "3. ";
+    Couleur (KBleu);
+    cout << "Mêlée" << endl;
+    Couleur (KReset);
     ShowPrompt (mode);
 
-    while (mode != 1 && mode != 2){
+    while (mode != 1 && mode != 2 && mode != 3){
         cout << endl << "Saisie incorrecte." << endl;
         ShowPrompt (mode);
     }
@@ -606,166 +6383,33 @@ int main (){
         ShowPrompt (matrixSize);
     }
     Couleur (KReset);
-
-    //! 610. Initialisation de la matrice.
-    CMatrix mat;
-    InitMat(mat, matrixSize);
+    if (broadcast && !StartBroadcast (broadcastName, matrixSize))
+        cerr << "Diffusion " << broadcastName << " impossible : " << strerror (errno) << endl;
 
     //! 614. On initialise les pseudo/couleur des joueurs.
-    CVPairStr VNameColor = InitPlayers (mode);
-
-    //! 617. Initialisation de VScore.
-    vector<unsigned> VScore;
-    for (unsigned i(0); i < VNameColor.size (); ++i)
-        VScore.push_back (0);
-	//! 621. Vecteur qui contiendra les "indices" des gagnants dans VNameColor.
-    vector<unsigned> nbWinners; 
-
-    //! 624. Boucle principale du jeu. Tourne jusqu'à ce qu'il ne reste plus de couple de joueurs.
-    for (unsigned playersCouple (0); playersCouple < VNameColor.size() - 1; playersCouple += 2){
-
-        //! 627. Quand une nouvelle partie commence, on réinitialise la position des joueurs et on fait disparaitre les pions spéciaux.
-        CPosition posRedSquare;
-        vector<CPosition> VPosCoin;
-
-        CPosition posPlayer1 = make_pair (0, matrixSize - 1);
-        CPosition posPlayer2 = make_pair (matrixSize - 1, 0);
-
-        //! 634. On place les pions des joueurs.
-        mat[posPlayer1.first][posPlayer1.second] = TokenPlayer1;
-        mat[posPlayer2.first][posPlayer2.second] = TokenPlayer2;
-
-        //! 638. (Ré)initialisation de quelques variables pour le jeu.
-        bool doesRedSquare = true;
-		
-        //! 641. Le nombre de tours est proportionnel à la taille de la matrice. Sinon si le plateau est top grand les joueurs ne pourraient pas s'atteindre.
-        unsigned compteTour = matrixSize * 1.5;
-        unsigned winner(0), cptJ1(0), cptJ2(0);
-        char move;
-
-        while (winner == 0){
-            if (compteTour == 0) break;
-
-            //! 649. Les instructions se répèteront pour le joueur 2.
-            for (unsigned turn(1); turn < 3; ++turn){
-
-                //! 652. Fait apparaitre aléatoirement les pions spéciaux sur le plateau.
-                if (doesRedSquare)
-                    MakeRedSquareAppear (mat, KTokenRedSquare, doesRedSquare, posRedSquare, 30, matrixSize, posPlayer1, posPlayer2);
-                MakeCoinAppear (mat, KTokenCoin, VPosCoin, 30, matrixSize, posPlayer1, posPlayer2);
-                ShowMatrix (mat, VNameColor, VScore, playersCouple);
-
-                //! 658. Passage en mode non canonique.
-                set_input_mode ();
-
-                //! 661. '1' tour n'est pas pluriel, vérification pour affichage correct.
-                Couleur (KBleu);
-                cout << compteTour;
-                Couleur (KReset);
-                cout << ((compteTour != 1) ? (" tours restants") : (" tour restant")) << endl;
-
-                //! 667. Saisie de la valeur du déplacement. Le prompt affiché est le bon pseudo de la bonne couleur.
-                cout << "C'est à ";
-                if (turn == 1){
-                    ShowColoredName (VNameColor[playersCouple]);
-                    ++cptJ1;
-                }
-                else if (turn == 2){
-                    ShowColoredName (VNameColor[playersCouple+1]);
-                    ++cptJ2;
-                }
-                cout << "de jouer :" << endl;
-                ShowPrompt (move);
-
-                //! 680. Le pion se déplace. C'est le pion 1 qui bouge si on est au tour 1 et inversement.
-                MoveToken (mat, move, ((turn == 1) ? (posPlayer1) : (posPlayer2)), turn, VNameColor, playersCouple, matrixSize);
-                ShowMatrix (mat, VNameColor, VScore, playersCouple);
-
-                //! 684. Si un des joueurs se trouve sur l'autre, il gagne.
-                if ((turn == 1) ? (posPlayer1 == posPlayer2) : (posPlayer2 == posPlayer1)){
-                    winner = ((turn == 1) ? (1) : (2));
-                    break;
-                }
-                //! 689. Si un des joueurs se trouve sur le carré rouge, il gagne.
-                if ((turn == 1) ? (posPlayer1 == posRedSquare) : (posPlayer2 == posRedSquare)){
-                    winner = ((turn == 1) ? (1) : (2));
-                    break;
-                }
-                //! 694. Si un des joueurs se trouve sur une pièce, il gagne un point.
-                for (CPosition pos : VPosCoin){
-                    if ((turn == 1) ? (posPlayer1 == pos) : (posPlayer2 == pos)){
-                        ++VScore [((turn == 1) ? (playersCouple) : (playersCouple + 1))];
-                    }
-                }
-            } // for ()
-            --compteTour;
-        } // while ()
-
-        if (winner == 0){
-            //! 705. Ici la sortie a été induite par "if (CompteTour == 0) break;". Le joueur qui a le plus de points gagne.
-            if (VScore [playersCouple] > VScore [playersCouple + 1]){
-                ShowColoredName (VNameColor [playersCouple]);
-                cout << " gagne grâce à ses " << VScore [playersCouple] << " points." << endl;
-            }
-            else if (VScore [playersCouple] < VScore [playersCouple + 1]){
-                ShowColoredName (VNameColor [playersCouple + 1]);
-                cout << " gagne grâce à ses " << VScore [playersCouple + 1] << " points." << endl;
-            }
-            else if (VScore [playersCouple] == VScore [playersCouple + 1])
-                cout << "Match nul !" << endl;
-
-        }
-        else if (winner == 1){
-            ShowColoredName (VNameColor[playersCouple]);
-            cout << "gagne en " << cptJ1 << " tours avec " << VScore [playersCouple] << " points." << endl;
+    CSession session;
+    session.mode     = mode;
+    session.baseSeed = baseSeed;
+    session.VNameColor = InitPlayers (mode, matrixSize, session.VKind);
+    //! Formule du tournoi en mode multijoueur.
+    session.format = (mode == 2) ? FormatChoose () : KKnockout;
+    session.tokens [0] = TokenPlayer1;
+    session.tokens [1] = TokenPlayer2;
+    session.config.matrixSize   = matrixSize;
+    session.config.botMs        = botMs;
+    session.config.clockSeconds = clockSeconds;
+    session.config.hasHuman     = find (session.VKind.begin (), session.VKind.end (), KHuman) != session.VKind.end ();
+    InitTournament (session.tour, session.format, session.VNameColor.size ());
+    session.checkpointTurns = checkpointTurns;
+    session.nbMatches       = 0;
+    session.liveMatch       = KNoMatch;
 
-            //! 722. On écrit l'"indice" du joueur 1 de VNameColor dans le vecteur nbWinners.
-            nbWinners.push_back (playersCouple);
-        }
-
-        else if (winner == 2){
-            ShowColoredName (VNameColor[playersCouple+1]);
-            cout << "gagne en " << cptJ2 << " tours avec " << VScore[playersCouple + 1] << " points." << endl;
-
-            //! 730. On écrit l'"indice" du joueur 2 de VNameColor dans le vecteur nbWinners.
-            nbWinners.push_back (playersCouple+1);
-        }
-
-        //! 734. On efface les pions du plateau (ils sont réinitialisés si la boucle for principale refait un tour).
-        mat[posPlayer1.first][posPlayer1.second] = KEmpty;
-        mat[posPlayer2.first][posPlayer2.second] = KEmpty;
-
-        //! 738. Peu importe ce que l'utilisateur entre, c'est pour mettre le terminal en "pause".
-        cout << endl << "Appuyez sur une touche pour continuer";
-        cin.get ();
-
-    } // for() principal
-
-    //! 744. Affichage des pseudos des gagnants de la bonne couleur. On affiche les pseudo/couleur des gagnants de VNameColor repérés par les valeurs de nbWinners en indice.
-    ClearScreen ();
-    cout << ((mode == 1) ? ("Le vainqueur a") : ("Les vainqueurs ont")) << " été :" << endl;
-    for (unsigned val : nbWinners){
-        Couleur (VNameColor [val].second);
-        cout << VNameColor [val].first << endl;
-        Couleur (KReset);
-    }
-
-    //! 753. On propose à l'utilisateur d'enregistrer le résultat {des, de la} partie(s) dans un fichier Resultat.txt qui est créé s'il n'existe pas.
-    char doesSave;
-    cout << endl << "Souhaitez-vous enregistrer les résultats des parties ? ('o' ou 'n') ";
-    ShowPrompt (doesSave);
-
-    while (doesSave != 'o' && doesSave != 'n'){
-        cout << "Saisie incorrecte. Veuillez saisir 'o' ou 'n' : ";
-        ShowPrompt (doesSave);
+    //! Points de reprise de la série, sauf pour la mêlée. Ceux d'une série interrompue auparavant sont effacés :
+    //! --resume ne doit pas pouvoir les préférer à ceux de la nouvelle série.
+    if (checkpointTurns && mode != 3){
+        RemoveCheckpoints ();
+        StartCheckpoints ([&session] (string & buffer) { EncodeSession (buffer, session); }, checkpointTurns, 0);
+        SaveCheckpoint ();
     }
-
-    if (doesSave == 'o')
-        SaveNames (VNameColor, nbWinners, VScore);
-
-    //! 766. Retour en mode canonique.
-    reset_input_mode ();
-
-    cout << endl;
-    return 0;
+    return PlaySession (session, matchTelemetry);
 } // main ()